@@ -1,55 +1,82 @@
 #include "eosio.wram.hpp"
+#include "src/state.cpp"
+#include "src/memo.cpp"
+#include "src/inline.cpp"
 #include "src/token.cpp"
 #include "src/egress.cpp"
 #include "src/config.cpp"
+#include "src/batch.cpp"
+#include "src/settlement.cpp"
+#include "src/query.cpp"
+#include "src/simulate.cpp"
+#include "src/purchase.cpp"
+#include "src/sell.cpp"
 
 namespace eosio {
 
 [[eosio::action]]
-void wram::unwrap( const name owner, const int64_t bytes )
+wram::transfer_result wram::unwrap( const name owner, const int64_t bytes )
 {
-   transfer(owner, get_self(), asset{bytes, RAM_SYMBOL}, "unwrap ram");
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   const transfer_result result = transfer_tokens(ctx, owner, get_self(), asset{bytes, RAM_SYMBOL}, "unwrap ram", owner);
+   save_context(ctx);
+   return result;
 }
 
-void wram::unwrap_ram( const name to, const asset quantity )
+[[eosio::action]]
+wram::transfer_result wram::unwrapto( const name owner, const name to, const int64_t bytes )
+{
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   const transfer_result result = transfer_tokens(ctx, owner, get_self(), asset{bytes, RAM_SYMBOL}, "unwrap ram", to);
+   save_context(ctx);
+   return result;
+}
+
+void wram::unwrap_ram( context& ctx, const name to, const asset quantity )
 {
    // validate incoming token transfer
-   check(quantity.symbol == RAM_SYMBOL, "Only the system " + RAM_SYMBOL.code().to_string() + " token is accepted for transfers.");
+   check(quantity.symbol == RAM_SYMBOL, wram_error::only_system_wram_accepted);
 
    // check status
-   config_table _config(get_self(), get_self().value);
-   config_row config = _config.get_or_default();
-   check(config.unwrap_ram_enabled, "unwrap ram is currently disabled");
+   check(get_state(ctx).unwrap_ram_enabled, wram_error::unwrap_ram_disabled);
 
-   // retire wram
-   retire_action retire_act{get_self(), {get_self(), "active"_n}};
-   retire_act.send(quantity, "unwrap ram");
+   // burn wram, already debited from the sender
+   burn(ctx, quantity);
 
    // ramtransfer to user
-   eosiosystem::system_contract::ramtransfer_action ramtransfer_act{"eosio"_n, {RAM_BANK, "active"_n}};
-   ramtransfer_act.send(RAM_BANK, to, quantity.amount, "unwrap ram");
+   send_from_bank(ctx, to, quantity.amount);
 }
 
-void wram::wrap_ram( const name to, const int64_t bytes )
+void wram::wrap_ram( context& ctx, const name to, const int64_t bytes )
 {
-   check(bytes > 0, "must transfer positive quantity");
-
-   // cannot have contract itself mint WRAM
-   check(to != get_self(), "cannot wrap ram to self" );
+   check(validate_wrap(ctx, to, bytes));
 
    const asset quantity{bytes, RAM_SYMBOL};
 
    // ramtransfer to rambank
-   eosiosystem::system_contract::ramtransfer_action ramtransfer_act{"eosio"_n, {get_self(), "active"_n}};
-   ramtransfer_act.send(get_self(), RAM_BANK, bytes, "wrap ram");
+   send_to_bank(ctx, bytes);
+
+   // mint wram directly to user (no inline issue & transfer)
+   mint(ctx, quantity);
+   add_balance(to, quantity, get_self());
 
-   // issue wram
-   issue_action issue_act{get_self(), {get_self(), "active"_n}};
-   issue_act.send(get_self(), quantity, "wrap ram");
+   // transfer receipt only, balances are already credited by mint
+   send_transfer(get_self(), to, quantity, "wrap ram");
+}
+
+wram_error wram::validate_wrap( context& ctx, const name to, const int64_t bytes )
+{
+   if (bytes <= 0) return wram_error::must_transfer_positive_quantity;
 
-   // transfer RAM tokens to user
-   transfer_action transfer_act{get_self(), {get_self(), "active"_n}};
-   transfer_act.send(get_self(), to, quantity, "wrap ram");
+   // cannot have contract itself mint WRAM
+   if (to == get_self()) return wram_error::cannot_wrap_ram_to_self;
+
+   // disable wrapping to accounts on egress list
+   if (is_egress(ctx, to)) return wram_error::transfer_disabled_to_account;
+
+   const auto& st = get_stat(ctx);
+   if (bytes > st.max_supply.amount - st.supply.amount) return wram_error::quantity_exceeds_available_supply;
+   return wram_error::none;
 }
 
 [[eosio::on_notify("eosio::logbuyram")]]
@@ -57,34 +84,94 @@ void wram::on_logbuyram( const name& payer, const name& receiver, const asset& q
 {
    // ignore buy ram not sent to this contract
    if (receiver != get_self()) { return; }
-   wrap_ram(payer, bytes);
+
+   // RAM bought by `buy_ram` is credited to the account named in the EOS transfer memo
+   name to = payer;
+   if (payer == get_self()) {
+      purchase_table _purchase(get_self(), get_self().value);
+      if (_purchase.exists()) {
+         to = _purchase.get().receiver;
+         _purchase.remove();
+      }
+   }
+
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   wrap_ram(ctx, to, bytes);
+   save_context(ctx);
 }
 
 // @user
 [[eosio::on_notify("eosio::ramtransfer")]]
 void wram::on_ramtransfer( const name from, const name to, const int64_t bytes, const string memo )
+{
+   on_ramtransfer_view(from, to, bytes, memo);
+}
+
+void wram::on_ramtransfer_view( const name from, const name to, const int64_t bytes, const string_view memo )
 {
    // ignore transfers not sent to this contract
    if (to != get_self()) { return; }
    if (memo == "ignore") { return; } // allow for internal RAM transfers
 
    // check status
-   config_table _config(get_self(), get_self().value);
-   config_row config = _config.get_or_default();
-   check(config.wrap_ram_enabled, "wrap ram is currently disabled");
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   check(get_state(ctx).wrap_ram_enabled, wram_error::wrap_ram_disabled);
+
+   // hold bytes until distributed by `wrapbatch`
+   if (memo == "batch") {
+      check(bytes > 0, wram_error::must_transfer_positive_quantity);
+      deposits _deposits(get_self(), get_self().value);
+      auto itr = _deposits.find(from.value);
+      if (itr == _deposits.end()) {
+         _deposits.emplace(get_self(), [&](auto& row) {
+            row.owner = from;
+            row.bytes = bytes;
+         });
+      } else {
+         _deposits.modify(itr, same_payer, [&](auto& row) {
+            row.bytes += bytes;
+         });
+      }
+      return;
+   }
+
+   // mint to `from`, or to `<account>` with the `wrap:<account>` memo
+   name receiver = from;
+   check(parse_route(memo, "wrap", from, receiver));
+   if (receiver != from) check(is_account(receiver), wram_error::to_account_does_not_exist);
 
-   wrap_ram(from, bytes);
+   wrap_ram(ctx, receiver, bytes);
+   save_context(ctx);
 }
 
 // @user
 [[eosio::on_notify("*::transfer")]]
 void wram::on_transfer( const name from, const name to, const asset quantity, const string memo )
+{
+   on_transfer_view(from, to, quantity, memo);
+}
+
+void wram::on_transfer_view( const name from, const name to, const asset quantity, const string_view memo )
 {
    // ignore transfers not sent to this contract
    if (to != get_self()) { return; }
 
+   // proceeds of `sellram`, forwarded by `sellpayout`
+   if (get_first_receiver() == EOS_CONTRACT && from == "eosio.ram"_n) { return; }
+
+   // EOS sent with a `wrap` memo buys RAM and mints WRAM
+   if (get_first_receiver() == EOS_CONTRACT) {
+      name receiver;
+      check(parse_route(memo, "wrap", from, receiver));
+      if (receiver) {
+         context ctx{get_self(), RAM_SYMBOL.code()};
+         buy_ram(ctx, receiver, quantity);
+         return;
+      }
+   }
+
    // unwrap is triggered by internal transfer method
-   check(false, "only " + get_self().to_string() + " token transfers are allowed");
+   check(false, wram_error::only_wram_transfers_allowed);
 }
 
 // @self
@@ -95,36 +182,36 @@ void wram::migrate()
 
    // Modify the max_supply to 256G
    uint64_t max_supply = 256LL * 1024 * 1024 * 1024;
-   stats statstable( get_self(), RAM_SYMBOL.code().raw() );
-   const auto& st = statstable.get( RAM_SYMBOL.code().raw(), "symbol does not exist" );
-   check(st.max_supply.amount != max_supply, "can only be executed once");
-   statstable.modify( st, same_payer, [&]( auto& s ) {
-      s.max_supply.amount = max_supply;
-   });
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   auto& st = get_stat(ctx);
+   check(st.max_supply.amount != max_supply, wram_error::can_only_be_executed_once);
+   st.max_supply.amount = max_supply;
+   ctx.stat_changed = true;
    
    // Retire the wram of eosio.wram so that the liquidity and issuance are equal
    accounts acnts( get_self(), get_self().value );
-   auto acnt = acnts.require_find( RAM_SYMBOL.code().raw() );
-   if(acnt->balance.amount > 0){
-      retire_action retire_act{get_self(), {get_self(), "active"_n}};
-      retire_act.send(acnt->balance, "retire mirror wram");
+   auto acnt = acnts.find( RAM_SYMBOL.code().raw() );
+   const int64_t self_balance = acnt != acnts.end() ? acnt->balance.amount : 0;
+   if(self_balance > 0){
+      send_retire(acnt->balance, "retire mirror wram");
    }
 
    // Migrate all ram to ram_bank
-   auto ram_bytes = st.supply.amount - acnt->balance.amount;
+   auto ram_bytes = st.supply.amount - self_balance;
    if(ram_bytes > 0){
-      eosiosystem::system_contract::ramtransfer_action ramtransfer_act{"eosio"_n, {get_self(), "active"_n}};
-      ramtransfer_act.send(get_self(), RAM_BANK, ram_bytes, "migrate to rambank");
+      send_ramtransfer(get_self(), RAM_BANK, ram_bytes, "migrate to rambank");
    }
 
    // Mint 128G wram to ram_bank 
    asset to_rams = {128LL * 1024 * 1024 * 1024, RAM_SYMBOL};
-   issue_action issue_act{get_self(), {get_self(), "active"_n}};
-   issue_act.send(get_self(), to_rams, "issue to rams");
+   mint(ctx, to_rams);
+   add_balance(RAM_BANK, to_rams, get_self());
+   save_context(ctx);
 
-   // transfer to ram_bank
-   transfer_action transfer_act{get_self(), {get_self(), "active"_n}};
-   transfer_act.send(get_self(), RAM_BANK, to_rams, "issue to rams");
+   // transfer receipt to ram_bank
+   send_transfer(get_self(), RAM_BANK, to_rams, "issue to rams");
 }
 
 } /// namespace eosio
+
+#include "src/apply.cpp"
@@ -4,6 +4,8 @@
 #include <eosio.system/eosio.system.hpp>
 #include <eosio/singleton.hpp>
 
+#include "src/errors.hpp"
+
 using namespace std;
 
 namespace eosio {
@@ -11,16 +13,54 @@ namespace eosio {
     * The `eosio.wram` contract is a contract that allows to wrap & unwrap system RAM at 1:1 using the `ramtransfer` method.
     */
    class [[eosio::contract("eosio.wram")]] wram : public contract {
-      const symbol RAM_SYMBOL = symbol("WRAM", 0);
-      const name RAM_BANK = "ramdeposit11"_n;
+      static constexpr symbol RAM_SYMBOL = symbol("WRAM", 0);
+      static constexpr name RAM_BANK = "ramdeposit11"_n;
 
       public:
          using contract::contract;
 
+         static constexpr name EOS_CONTRACT = "eosio.token"_n;
+
+         /**
+          * ## TABLE `state`
+          *
+          * > global state of the contract, read once and written back once per action
+          *
+          * WRAM supply always equals the bytes held by the RAM bank plus `pending_bytes`.
+          *
+          * ### params
+          *
+          * - `{bool} wrap_ram_enabled` - whether wrapping RAM is enabled (Only limited to converting from ram to wram, not limiting eos to wram)
+          * - `{bool} unwrap_ram_enabled` - whether unwrapping RAM is enabled
+          * - `{int64_t} settle_threshold` - pending bytes that trigger a settlement with the RAM bank (0 = settle every wrap)
+          * - `{int64_t} pending_bytes` - wrapped RAM bytes held by the contract, not yet sent to the RAM bank
+          * - `{vector<name>} egress` - sorted copy of the egress list, checked by transfers without reading `egresslist`
+          *
+          * ### example
+          *
+          * ```json
+          * {
+          *     "wrap_ram_enabled": true,
+          *     "unwrap_ram_enabled": true,
+          *     "settle_threshold": 0,
+          *     "pending_bytes": 0,
+          *     "egress": ["eosio.ram"]
+          * }
+          * ```
+          */
+         struct [[eosio::table("state")]] state_row {
+            bool     wrap_ram_enabled = true;
+            bool     unwrap_ram_enabled = false;
+            int64_t  settle_threshold = 0;
+            int64_t  pending_bytes = 0;
+            vector<name> egress;
+         };
+         typedef eosio::singleton<"state"_n, state_row> state_table;
+
          /**
           * ## TABLE `config`
           *
-          * > configuration settings for the contract, specifically related to RAM management operations
+          * > (legacy) configuration settings for the contract, read once to seed the `state` table
           *
           * ### params
           *
@@ -45,7 +85,7 @@ namespace eosio {
          /**
           * ## TABLE `egresslist`
           *
-          * > block transfers to any account in the egress list
+          * > block transfers to any account in the egress list (source of truth for `state.egress`)
           *
           * ### params
           *
@@ -66,6 +106,87 @@ namespace eosio {
          };
          typedef eosio::multi_index< "egresslist"_n, egresslist_row > egresslist;
 
+         /**
+          * ## TABLE `deposits`
+          *
+          * > RAM bytes sent with the `batch` memo, held until distributed by `wrapbatch` or returned by `refundbatch`
+          *
+          * ### params
+          *
+          * - `{name} owner` - account that sent the RAM bytes
+          * - `{int64_t} bytes` - RAM bytes not yet wrapped
+          *
+          * ### example
+          *
+          * ```json
+          * {
+          *     "owner": "alice",
+          *     "bytes": 3000
+          * }
+          * ```
+          */
+         struct [[eosio::table("deposits")]] deposits_row {
+            name     owner;
+            int64_t  bytes;
+
+            uint64_t primary_key()const { return owner.value; }
+         };
+         typedef eosio::multi_index< "deposits"_n, deposits_row > deposits;
+
+         /**
+          * ## TABLE `purchase`
+          *
+          * > WRAM recipient of an EOS transfer, set by `on_transfer` and consumed by `on_logbuyram` of the inline `buyram`
+          *
+          * ### params
+          *
+          * - `{name} receiver` - account credited with the purchased WRAM
+          *
+          * ### example
+          *
+          * ```json
+          * {
+          *     "receiver": "bob"
+          * }
+          * ```
+          */
+         struct [[eosio::table("purchase")]] purchase_row {
+            name     receiver;
+         };
+         typedef eosio::singleton<"purchase"_n, purchase_row> purchase_table;
+
+         /**
+          * An `account` and RAM `bytes` pair used by batched wrap & unwrap actions.
+          */
+         struct batch_entry {
+            name     account;
+            int64_t  bytes;
+         };
+
+         /**
+          * A single recipient of the `sendmany` action.
+          */
+         struct transfer_entry {
+            name     to;
+            asset    quantity;
+            string   memo;
+         };
+
+         /**
+          * Post-state returned by `transfer` and `unwrap`.
+          *
+          * - `{asset} from_balance` - resulting balance of the sender
+          * - `{asset} to_balance` - resulting balance of the recipient
+          * - `{asset?} supply` - resulting WRAM supply, only set by an unwrap or a wrap (a plain transfer does not read it)
+          * - `{int64_t} bytes` - RAM bytes delivered by an unwrap or received by a wrap
+          */
+         struct transfer_result {
+            asset             from_balance{0, RAM_SYMBOL};
+            asset             to_balance{0, RAM_SYMBOL};
+            optional<asset>   supply;
+            int64_t           bytes = 0;
+         };
+
          /**
          * Configure wrap/unwrap ram status.
          *
@@ -75,6 +196,23 @@ namespace eosio {
          [[eosio::action]]
          void cfg( const bool wrap_ram_enabled, const bool unwrap_ram_enabled );
 
+         /**
+         * Configure netted settlement with the RAM bank.
+         *
+         * Pending bytes share the contract's RAM quota with the rows it pays for (balances, deposits, purchase & state),
+         * the contract account must keep free RAM apart from pending bytes for the rows created between settlements.
+         *
+         * @param settle_threshold  Pending bytes that trigger a settlement (0 disables netting and settles any pending bytes)
+         */
+         [[eosio::action]]
+         void cfgsettle( const int64_t settle_threshold );
+
+         /**
+          * Send all pending wrapped RAM bytes held by the contract to the RAM bank.
+          */
+         [[eosio::action]]
+         void settle();
+
          /**
           * Add accounts to the egress list.
           *
@@ -96,12 +234,72 @@ namespace eosio {
           *
           * @param owner - the account to unwrap WRAM tokens from,
           * @param bytes - the amount of system RAM to unwrap.
+          *
+          * @return the resulting balance, supply and RAM bytes delivered
+          */
+         [[eosio::action]]
+         transfer_result unwrap( const name owner, const int64_t bytes );
+
+         /**
+          * Unwrap WRAM tokens of `owner` to system RAM `bytes` delivered to `to`
+          *
+          * Same as a transfer to this contract with the `unwrap:<to>` memo.
+          *
+          * @param owner - the account to unwrap WRAM tokens from,
+          * @param to - the account receiving the system RAM,
+          * @param bytes - the amount of system RAM to unwrap.
+          *
+          * @return the resulting balance, supply and RAM bytes delivered
           */
          [[eosio::action]]
-         void unwrap( const name owner, const int64_t bytes );
+         transfer_result unwrapto( const name owner, const name to, const int64_t bytes );
 
          /**
-          * Send system RAM `bytes` to contract to issue `RAM` tokens to sender.
+          * Unwrap WRAM tokens of many owners to system RAM in a single call
+          *
+          * @param owners - the accounts to unwrap WRAM tokens from and the amount of system RAM to unwrap for each of them.
+          */
+         [[eosio::action]]
+         void unwrapbatch( const vector<batch_entry> owners );
+
+         /**
+          * Sell WRAM tokens for EOS: burns the WRAM, sells the RAM through the system contract
+          * and sends the proceeds to `owner`.
+          *
+          * @param owner - the account to sell WRAM tokens from,
+          * @param bytes - the amount of WRAM to sell.
+          */
+         [[eosio::action]]
+         void sellwram( const name owner, const int64_t bytes );
+
+         /**
+          * Send the EOS received from `sellram` since `balance` was read to `owner` (internal, sent by `sellwram`).
+          *
+          * @param owner - the account selling WRAM,
+          * @param balance - EOS balance of the contract before `sellram`.
+          */
+         [[eosio::action]]
+         void sellpayout( const name owner, const asset balance );
+
+         /**
+          * Wrap RAM bytes previously sent with the `batch` memo to many recipients at once.
+          *
+          * @param owner - the account that deposited the RAM bytes,
+          * @param recipients - accounts to credit and the WRAM amount for each of them.
+          */
+         [[eosio::action]]
+         void wrapbatch( const name owner, const vector<batch_entry> recipients );
+
+         /**
+          * Return RAM bytes sent with the `batch` memo and not yet distributed by `wrapbatch` to `owner`.
+          *
+          * @param owner - the account that deposited the RAM bytes.
+          */
+         [[eosio::action]]
+         void refundbatch( const name owner );
+
+         /**
+          * Send system RAM `bytes` to contract to issue `RAM` tokens to sender, or to `<account>` with the `wrap:<account>` memo.
           */
          [[eosio::on_notify("eosio::ramtransfer")]]
          void on_ramtransfer(const name from, const name to, const int64_t bytes, const string memo);
@@ -113,7 +311,12 @@ namespace eosio {
          void on_logbuyram( const name& payer, const name& receiver, const asset& quantity, int64_t bytes, int64_t ram_bytes );
 
          /**
-          * Disallow sending tokens to this contract.
+          * Buy RAM with EOS sent from `eosio.token` and mint WRAM in the same action chain.
+          *
+          * - memo `wrap` credits the sender
+          * - memo `wrap:<account>` credits `<account>`
+          *
+          * EOS from `eosio.ram` (proceeds of `sellwram`) is accepted, any other token transfer to this contract is rejected.
           */
          [[eosio::on_notify("*::transfer")]]
          void on_transfer(const name from, const name to, const asset quantity, const string memo);
@@ -156,16 +359,31 @@ namespace eosio {
           * Allows `from` account to transfer to `to` account the `quantity` tokens.
           * One account is debited and the other is credited with quantity tokens.
           *
+          * Tokens sent to this contract are unwrapped to `from`, or to `<account>` with the `unwrap:<account>` memo.
+          *
           * @param from - the account to transfer from,
           * @param to - the account to be transferred to,
           * @param quantity - the quantity of tokens to be transferred,
           * @param memo - the memo string to accompany the transaction.
+          *
+          * @return the resulting balances and supply
+          */
+         [[eosio::action]]
+         transfer_result transfer( const name&    from,
+                                   const name&    to,
+                                   const asset&   quantity,
+                                   const string&  memo );
+         /**
+          * Allows `from` account to transfer tokens to many accounts at once.
+          * The sender is debited once by the total, every recipient is credited and notified by a `transfer` receipt
+          * with its own memo, instead of the `sendmany` action carrying the other recipients.
+          *
+          * @param from - the account to transfer from,
+          * @param transfers - the recipients with the quantity and memo for each of them.
           */
          [[eosio::action]]
-         void transfer( const name&    from,
-                        const name&    to,
-                        const asset&   quantity,
-                        const string&  memo );
+         void sendmany( const name& from, const vector<transfer_entry>& transfers );
+
          /**
           * Allows `ram_payer` to create an account `owner` with zero balance for
           * token `symbol` at the expense of `ram_payer`.
@@ -203,6 +421,125 @@ namespace eosio {
          [[eosio::action]]
          void migrate();
 
+         /**
+          * Write the `state` row, seeded from the legacy `config` & `egresslist` tables when missing,
+          * so that actions stop reading the legacy tables before an admin changes the configuration.
+          */
+         [[eosio::action]]
+         void initstate();
+
+         /**
+          * Get the WRAM balance of `owner`.
+          *
+          * @param owner - the account to get the balance of.
+          *
+          * @return the WRAM balance (zero when the owner has no balance row)
+          */
+         [[eosio::action, eosio::read_only]]
+         asset getbalance( const name owner );
+
+         /**
+          * Get the WRAM balances of many `owners` in a single call.
+          *
+          * @param owners - the accounts to get the balance of.
+          *
+          * @return the WRAM balance of each owner, in order (zero when the owner has no balance row)
+          */
+         [[eosio::action, eosio::read_only]]
+         vector<asset> getbalances( const vector<name> owners );
+
+         /**
+          * Quote the RAM bytes bought by each EOS amount, after the 0.5% system fee.
+          *
+          * @param quantities - the EOS amounts to quote.
+          *
+          * @return the RAM bytes (and therefore WRAM) bought by each amount, in order
+          */
+         [[eosio::action, eosio::read_only]]
+         vector<int64_t> quote( const vector<asset> quantities );
+
+         /**
+          * Quote the EOS cost of buying each amount of RAM bytes, including the 0.5% system fee.
+          *
+          * @param bytes - the RAM bytes to quote.
+          *
+          * @return the EOS cost of each amount, in order
+          */
+         [[eosio::action, eosio::read_only]]
+         vector<asset> quotecost( const vector<int64_t> bytes );
+
+         /**
+          * Get the current WRAM supply.
+          *
+          * @return the WRAM supply
+          */
+         [[eosio::action, eosio::read_only]]
+         asset getsupply();
+
+         /**
+          * Get the global state of the contract.
+          *
+          * @return the `state` row
+          */
+         [[eosio::action, eosio::read_only]]
+         state_row getstate();
+
+         /**
+          * Outcome of a simulated action.
+          *
+          * - `{bool} success` - whether every check passes
+          * - `{string} error` - message of the first failing check (empty when built with `WRAM_ERROR_CODES`)
+          * - `{uint64_t} error_code` - code of the first failing check, see `errors.ts`
+          * - `{asset} from_balance` - resulting balance of the sender
+          * - `{asset} to_balance` - resulting balance of the recipient
+          * - `{asset} supply` - resulting WRAM supply
+          * - `{vector<name>} new_balances` - accounts whose balance row would be created
+          */
+         struct simulate_result {
+            bool           success = false;
+            string         error;
+            uint64_t       error_code = 0;
+            asset          from_balance{0, RAM_SYMBOL};
+            asset          to_balance{0, RAM_SYMBOL};
+            asset          supply{0, RAM_SYMBOL};
+            vector<name>   new_balances;
+         };
+
+         /**
+          * Run the validation of `transfer` without changing any state.
+          *
+          * @return the resulting balances or the first failing check
+          */
+         [[eosio::action, eosio::read_only]]
+         simulate_result simtransfer( const name from, const name to, const asset quantity, const string memo );
+
+         /**
+          * Run the validation of `unwrap` without changing any state.
+          *
+          * @return the resulting balances or the first failing check
+          */
+         [[eosio::action, eosio::read_only]]
+         simulate_result simunwrap( const name owner, const int64_t bytes );
+
+         /**
+          * Run the validation of wrapping RAM with `ramtransfer` without changing any state.
+          *
+          * @param from - the account sending the system RAM,
+          * @param to - the account credited with WRAM, `from` or the `<account>` of a `wrap:<account>` memo,
+          * @param bytes - the amount of system RAM to wrap.
+          *
+          * @return the resulting balances or the first failing check
+          */
+         [[eosio::action, eosio::read_only]]
+         simulate_result simwrap( const name from, const name to, const int64_t bytes );
+
+         /**
+          * Bodies of `transfer`, `on_transfer` & `on_ramtransfer`, called by `apply` with the memo viewed in place in the action data.
+          */
+         transfer_result transfer_view( const name from, const name to, const asset quantity, const string_view memo );
+         void on_transfer_view( const name from, const name to, const asset quantity, const string_view memo );
+         void on_ramtransfer_view( const name from, const name to, const int64_t bytes, const string_view memo );
+
          static asset get_supply( const name& token_contract_account, const symbol_code& sym_code )
          {
             stats statstable( token_contract_account, sym_code.raw() );
@@ -221,6 +558,8 @@ namespace eosio {
          using issue_action = eosio::action_wrapper<"issue"_n, &wram::issue>;
          using retire_action = eosio::action_wrapper<"retire"_n, &wram::retire>;
          using transfer_action = eosio::action_wrapper<"transfer"_n, &wram::transfer>;
+         using sendmany_action = eosio::action_wrapper<"sendmany"_n, &wram::sendmany>;
+         using sellpayout_action = eosio::action_wrapper<"sellpayout"_n, &wram::sellpayout>;
          using open_action = eosio::action_wrapper<"open"_n, &wram::open>;
          using close_action = eosio::action_wrapper<"close"_n, &wram::close>;
       private:
@@ -241,11 +580,92 @@ namespace eosio {
          typedef eosio::multi_index< "accounts"_n, account > accounts;
          typedef eosio::multi_index< "stat"_n, currency_stats > stats;
 
-         void unwrap_ram( const name to, const asset quantity );
-         void wrap_ram( const name to, const int64_t bytes );
-         void check_disable_transfer( const name receiver );
+         /**
+          * Contract state shared by every step of an action: `state` and `stat` rows are
+          * loaded on first use and written back once by `save_context`.
+          */
+         struct context {
+            context( const name self, const symbol_code sym ) : _state(self, self.value), _stats(self, sym.raw()) {}
+
+            state_table       _state;
+            stats             _stats;
+            state_row         state;
+            currency_stats    stat;
+            bool              state_loaded = false;
+            bool              state_exists = false;
+            bool              state_changed = false;
+            bool              stat_loaded = false;
+            bool              stat_changed = false;
+         };
+
+         /**
+          * Symbol checks of the token paths. `Fixed` resolves them at compile time against
+          * `RAM_SYMBOL`, otherwise the `stat` row is read as in a generic eosio.token contract.
+          */
+         template <bool Fixed = true>
+         bool valid_symbol( context& ctx, const symbol& sym )
+         {
+            if constexpr (Fixed) {
+               return sym == RAM_SYMBOL;
+            } else {
+               return sym == get_stat(ctx).supply.symbol;
+            }
+         }
+
+         state_row& get_state( context& ctx );
+         currency_stats& get_stat( context& ctx );
+         void save_context( context& ctx );
+
+         transfer_result transfer_tokens( context& ctx, const name& from, const name& to, const asset& quantity, const string_view memo, const name receiver );
+         void unwrap_ram( context& ctx, const name to, const asset quantity );
+         void wrap_ram( context& ctx, const name to, const int64_t bytes );
+         void check_disable_transfer( context& ctx, const name receiver );
+         bool is_egress( context& ctx, const name receiver );
+         void buy_ram( context& ctx, const name receiver, const asset quantity );
+         asset get_eos_balance( const symbol sym );
+
+         // `<prefix>` routes to `sender`, `<prefix>:<account>` routes to `<account>`, `to` is left unchanged by any other memo
+         static wram_error parse_route( const string_view memo, const string_view prefix, const name sender, name& to );
+
+         /**
+          * Balance rows read while validating a transfer, reused by the transfer itself.
+          */
+         struct transfer_plan {
+            transfer_plan( const name self, const name from, const name to, const name receiver ) : from_acnts(self, from.value), to_acnts(self, to.value), receiver(receiver) {}
+
+            accounts                   from_acnts;
+            accounts::const_iterator   from_itr;
+            accounts                   to_acnts;
+            accounts::const_iterator   to_itr;
+            name                       receiver;   // receiver of the system RAM of an unwrap, rerouted by an `unwrap:<account>` memo
+         };
+
+         // first failing check, `wram_error::none` when every check passes
+         wram_error validate_transfer( context& ctx, transfer_plan& plan, const name& from, const name& to, const asset& quantity, const string_view memo );
+         wram_error validate_wrap( context& ctx, const name to, const int64_t bytes );
+
+         // inline actions packed straight into a reusable buffer, sent without building an `eosio::action`
+         void send_ramtransfer( const name from, const name to, const int64_t bytes, const string_view memo );
+         void send_transfer( const name contract, const name to, const asset& quantity, const string_view memo );
+         void send_receipt( const name from, const name to, const asset& quantity, const string_view memo );
+         void send_retire( const asset& quantity, const string_view memo );
+
+         void send_to_bank( context& ctx, const int64_t bytes );
+         void send_from_bank( context& ctx, const name to, const int64_t bytes );
+         void settle_pending( context& ctx );
+
+         void mint( context& ctx, const asset& quantity );
+         void burn( context& ctx, const asset& quantity );
+
+         // system contract RAM market math (buyram & buyrambytes)
+         static eosiosystem::system_contract::exchange_state get_ram_market();
+         static int64_t get_bancor_output( const int64_t inp_reserve, const int64_t out_reserve, const int64_t inp );
+         static int64_t get_bancor_input( const int64_t out_reserve, const int64_t inp_reserve, const int64_t out );
+         static int64_t get_fee( const int64_t amount );
 
          void sub_balance( const name& owner, const asset& value );
+         void sub_balance( accounts& from_acnts, const accounts::const_iterator from, const name& owner, const asset& value );
          void add_balance( const name& owner, const asset& value, const name& ram_payer );
+         void add_balance( accounts& to_acnts, const accounts::const_iterator to, const asset& value, const name& ram_payer );
    };
 } /// namespace eosio
@@ -2,6 +2,7 @@ import { Asset, Int64, Name } from '@wharfkit/antelope'
 import { AccountPermission, Blockchain, expectToThrow } from '@eosnetwork/vert'
 import { Name as Ne, Authority, PermissionLevel } from '@greymass/eosio'
 import { describe, expect, test } from 'bun:test'
+import { WRAM_ERRORS, decodeError } from './errors'
 
 // Vert EOS VM
 const blockchain = new Blockchain()
@@ -15,7 +16,8 @@ blockchain.createAccounts(bob, alice, charles, ram_bank, ...egress_list)
 
 const wram_contract = 'eosio.wram'
 const contracts = {
-    wram: blockchain.createContract(wram_contract, wram_contract, true),
+    // `WRAM_CONTRACT=build/lean/eosio.wram` runs the suite against the lean build
+    wram: blockchain.createContract(wram_contract, process.env.WRAM_CONTRACT ?? wram_contract, true),
     token: blockchain.createContract('eosio.token', 'external/eosio.token/eosio.token', true),
     system: blockchain.createContract('eosio', 'external/eosio.system/eosio', true),
     fake: {
@@ -45,8 +47,13 @@ interface Config {
     unwrap_ram_enabled: boolean
 }
 
+function getState() {
+    return contracts.wram.tables.state().getTableRows()[0]
+}
+
 function getConfig(): Config {
-    return contracts.wram.tables.config().getTableRows()[0]
+    const { wrap_ram_enabled, unwrap_ram_enabled } = getState()
+    return { wrap_ram_enabled, unwrap_ram_enabled }
 }
 
 function getTokenBalance(account: string, symcode: string) {
@@ -78,6 +85,65 @@ function getEgressList(account: string) {
     return Name.from(row.account).toString()
 }
 
+function getSettlement() {
+    const row = getState()
+    if (!row) return { settle_threshold: 0, pending_bytes: 0 }
+    return {
+        settle_threshold: Int64.from(row.settle_threshold).toNumber(),
+        pending_bytes: Int64.from(row.pending_bytes).toNumber(),
+    }
+}
+
+function getReturnValue() {
+    return blockchain.actionTraces[blockchain.actionTraces.length - 1].decodedReturnValue
+}
+
+// return value of the last `action` executed by the contract itself, notifications carry none
+function getActionReturnValue(action: string) {
+    const traces = blockchain.actionTraces.filter(
+        (trace) => !trace.isNotification && trace.action.toString() === action
+    )
+    return traces[traces.length - 1].decodedReturnValue
+}
+
+function getPurchase() {
+    return contracts.wram.tables.purchase(Name.from(wram_contract).value.value).getTableRows()[0]
+}
+
+function getEosBalance(account: string) {
+    const scope = Name.from(account).value.value
+    const primary_key = Asset.SymbolCode.from('EOS').value.value
+    const row = contracts.token.tables.accounts(scope).getTableRow(primary_key)
+    if (!row) return 0
+    return Asset.from(row.balance).units.toNumber()
+}
+
+function getDeposit(account: string) {
+    const primary_key = Name.from(account).value.value
+    const row = contracts.wram.tables.deposits(Name.from(wram_contract).value.value).getTableRow(primary_key)
+    if (!row) return 0
+    return Int64.from(row.bytes).toNumber()
+}
+
+function hasTokenRow(account: string, symcode: string) {
+    const scope = Name.from(account).value.value
+    const primary_key = Asset.SymbolCode.from(symcode).value.value
+    return contracts.wram.tables.accounts(scope).getTableRow(primary_key) !== undefined
+}
+
+// WRAM `transfer` receipts sent by the contract to `account` in the last transaction, `from` the contract unless given
+function getReceipts(account: string, from = wram_contract) {
+    return blockchain.actionTraces
+        .filter((trace) => !trace.isNotification && trace.action.toString() === 'transfer')
+        .map((trace) => trace.decodedData)
+        .filter(
+            (data) =>
+                Name.from(data.from).toString() === from &&
+                Name.from(data.to).toString() === account &&
+                Asset.from(data.quantity).symbol.code.toString() === RAM_SYMBOL
+        )
+}
+
 describe(wram_contract, () => {
     test('eosio::init', async () => {
         await contracts.system.actions.init([]).send()
@@ -325,6 +391,7 @@ describe(wram_contract, () => {
         for (const to of egress_list) {
             expect(getEgressList(to)).toBe(to)
         }
+        expect(getState().egress).toEqual(egress_list)
     })
 
     test('egresslist::transfer::error - cannot transfer to egress list', async () => {
@@ -334,23 +401,31 @@ describe(wram_contract, () => {
         }
     })
 
+    test('egresslist::transfer::error - egress check runs before balance checks', async () => {
+        for (const to of egress_list) {
+            const action = contracts.wram.actions.transfer([charles, to, `999999999 ${RAM_SYMBOL}`, '']).send(charles)
+            await expectToThrow(action, 'eosio_assert: transfer disabled to account')
+        }
+    })
+
     test('egresslist - removeegress', async () => {
         await contracts.wram.actions.removeegress([egress_list]).send(wram_contract)
         for (const to of egress_list) {
             expect(getEgressList(to)).toBe('')
         }
+        expect(getState().egress).toEqual([])
     })
 
     test('transfer::error - fake eosio.token WRAM', async () => {
         const action = contracts.fake.token.actions
             .transfer([alice, wram_contract, `1000 ${RAM_SYMBOL}`, ''])
             .send(alice)
-        await expectToThrow(action, 'eosio_assert_message: only eosio.wram token transfers are allowed')
+        await expectToThrow(action, 'eosio_assert: only eosio.wram token transfers are allowed')
     })
 
     test('transfer::error - not allowed to send EOS or any eosio.token', async () => {
         const action = contracts.token.actions.transfer([alice, wram_contract, `1000.0000 EOS`, '']).send(alice)
-        await expectToThrow(action, 'eosio_assert_message: only eosio.wram token transfers are allowed')
+        await expectToThrow(action, 'eosio_assert: only eosio.wram token transfers are allowed')
     })
 
     test('transfer::error - missing required authority eosio.token', async () => {
@@ -385,6 +460,13 @@ describe(wram_contract, () => {
         await expectToThrow(action, 'eosio_assert: must transfer positive quantity')
     })
 
+    test('transfer::error - memo check runs before balance checks', async () => {
+        const action = contracts.wram.actions
+            .transfer([charles, bob, `999999999 ${RAM_SYMBOL}`, 'x'.repeat(257)])
+            .send(charles)
+        await expectToThrow(action, 'eosio_assert: memo has more than 256 bytes')
+    })
+
     test('transfer::error - cannot transfer to self', async () => {
         const action = contracts.wram.actions
             .transfer([wram_contract, wram_contract, `0 ${RAM_SYMBOL}`, ''])
@@ -452,6 +534,12 @@ describe(wram_contract, () => {
             'eosio_assert: unwrap ram is currently disabled'
         )
 
+        // status check runs before balance checks
+        await expectToThrow(
+            contracts.wram.actions.transfer([charles, wram_contract, `999999999 ${RAM_SYMBOL}`, '']).send(charles),
+            'eosio_assert: unwrap ram is currently disabled'
+        )
+
     })
 
     test('unwrapram::enabled', async () => {
@@ -505,4 +593,553 @@ describe(wram_contract, () => {
     test('migrate::error - can only be executed once', async () => {
         await expectToThrow(contracts.wram.actions.migrate().send(), 'eosio_assert: can only be executed once')
     })
+
+    test('wrapbatch', async () => {
+        const before = {
+            bob: getTokenBalance(bob, RAM_SYMBOL),
+            charles: getTokenBalance(charles, RAM_SYMBOL),
+            supply: getTokenSupply(RAM_SYMBOL),
+            ram_bank: getRamBytes(ram_bank),
+        }
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 3000, 'batch']).send(alice)
+        expect(getDeposit(alice)).toBe(3000)
+
+        await contracts.wram.actions
+            .wrapbatch([
+                alice,
+                [
+                    { account: bob, bytes: 1000 },
+                    { account: charles, bytes: 2000 },
+                ],
+            ])
+            .send(alice)
+        expect(getReceipts(bob).map((receipt) => Asset.from(receipt.quantity).units.toNumber())).toEqual([1000])
+        expect(getReceipts(charles).map((receipt) => Asset.from(receipt.quantity).units.toNumber())).toEqual([2000])
+        expect(getTokenBalance(bob, RAM_SYMBOL) - before.bob).toBe(1000)
+        expect(getTokenBalance(charles, RAM_SYMBOL) - before.charles).toBe(2000)
+        expect(getTokenSupply(RAM_SYMBOL) - before.supply).toBe(3000)
+        expect(getRamBytes(ram_bank) - before.ram_bank).toBe(3000)
+        expect(getDeposit(alice)).toBe(0)
+    })
+
+    test('wrapbatch::error - recipients exceed ram deposit', async () => {
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 1000, 'batch']).send(alice)
+        const action = contracts.wram.actions
+            .wrapbatch([alice, [{ account: bob, bytes: 1001 }]])
+            .send(alice)
+        await expectToThrow(action, 'eosio_assert: recipients exceed ram deposit')
+    })
+
+    test('wrapbatch::error - no ram deposit found', async () => {
+        const action = contracts.wram.actions.wrapbatch([bob, [{ account: alice, bytes: 1 }]]).send(bob)
+        await expectToThrow(action, 'eosio_assert: no ram deposit found')
+    })
+
+    test('unwrapbatch', async () => {
+        const before = {
+            bob: { bytes: getRamBytes(bob), RAM: getTokenBalance(bob, RAM_SYMBOL) },
+            charles: { bytes: getRamBytes(charles), RAM: getTokenBalance(charles, RAM_SYMBOL) },
+            supply: getTokenSupply(RAM_SYMBOL),
+            ram_bank: getRamBytes(ram_bank),
+        }
+        await contracts.wram.actions
+            .unwrapbatch([
+                [
+                    { account: bob, bytes: 300 },
+                    { account: charles, bytes: 500 },
+                    { account: bob, bytes: 200 },
+                ],
+            ])
+            .send([`${bob}@active`, `${charles}@active`])
+        expect(getRamBytes(bob) - before.bob.bytes).toBe(500)
+        expect(getRamBytes(charles) - before.charles.bytes).toBe(500)
+        expect(getTokenBalance(bob, RAM_SYMBOL) - before.bob.RAM).toBe(-500)
+        expect(getTokenBalance(charles, RAM_SYMBOL) - before.charles.RAM).toBe(-500)
+        expect(getTokenSupply(RAM_SYMBOL) - before.supply).toBe(-1000)
+        expect(getRamBytes(ram_bank) - before.ram_bank).toBe(-1000)
+    })
+
+    test('unwrapbatch::error - missing required authority', async () => {
+        const action = contracts.wram.actions.unwrapbatch([[{ account: charles, bytes: 100 }]]).send(bob)
+        await expectToThrow(action, 'missing required authority charles')
+    })
+
+    test('sendmany', async () => {
+        const before = {
+            alice: getTokenBalance(alice, RAM_SYMBOL),
+            bob: getTokenBalance(bob, RAM_SYMBOL),
+            charles: getTokenBalance(charles, RAM_SYMBOL),
+        }
+        await contracts.wram.actions
+            .sendmany([
+                alice,
+                [
+                    { to: bob, quantity: `100 ${RAM_SYMBOL}`, memo: 'payroll' },
+                    { to: charles, quantity: `200 ${RAM_SYMBOL}`, memo: '' },
+                    { to: bob, quantity: `50 ${RAM_SYMBOL}`, memo: '' },
+                ],
+            ])
+            .send(alice)
+        expect(getReceipts(bob, alice).map(({ quantity, memo }) => [Asset.from(quantity).toString(), String(memo)])).toEqual([
+            [`100 ${RAM_SYMBOL}`, 'payroll'],
+            [`50 ${RAM_SYMBOL}`, ''],
+        ])
+        expect(getReceipts(charles, alice).map(({ quantity, memo }) => [Asset.from(quantity).toString(), String(memo)])).toEqual([
+            [`200 ${RAM_SYMBOL}`, ''],
+        ])
+        expect(getTokenBalance(alice, RAM_SYMBOL) - before.alice).toBe(-350)
+        expect(getTokenBalance(bob, RAM_SYMBOL) - before.bob).toBe(150)
+        expect(getTokenBalance(charles, RAM_SYMBOL) - before.charles).toBe(200)
+    })
+
+    test('sendmany::error', async () => {
+        await expectToThrow(
+            contracts.wram.actions.sendmany([alice, [{ to: bob, quantity: `1 ${RAM_SYMBOL}`, memo: '' }]]).send(bob),
+            'missing required authority alice'
+        )
+        await expectToThrow(
+            contracts.wram.actions
+                .sendmany([alice, [{ to: wram_contract, quantity: `1 ${RAM_SYMBOL}`, memo: '' }]])
+                .send(alice),
+            'eosio_assert: cannot unwrap with sendmany'
+        )
+        await expectToThrow(
+            contracts.wram.actions
+                .sendmany([charles, [{ to: bob, quantity: `999999999 ${RAM_SYMBOL}`, memo: '' }]])
+                .send(charles),
+            'eosio_assert: overdrawn balance'
+        )
+    })
+
+    test('read_only::getbalance', async () => {
+        await contracts.wram.actions.getbalance([alice]).send()
+        expect(Asset.from(getReturnValue()).units.toNumber()).toBe(getTokenBalance(alice, RAM_SYMBOL))
+
+        // same as `getbalances` for an account without balance row
+        await contracts.wram.actions.getbalance([egress_list[0]]).send()
+        expect(Asset.from(getReturnValue()).units.toNumber()).toBe(0)
+    })
+
+    test('read_only::getbalances', async () => {
+        const owners = [alice, egress_list[0], bob]
+        await contracts.wram.actions.getbalances([owners]).send()
+        const balances = getReturnValue().map((balance: string) => Asset.from(balance).units.toNumber())
+        expect(balances).toEqual(owners.map((owner) => getTokenBalance(owner, RAM_SYMBOL)))
+        expect(balances[1]).toBe(0)
+    })
+
+    test('read_only::quote', async () => {
+        await contracts.wram.actions.quote([[`1.0000 EOS`, `10.0000 EOS`]]).send()
+        const [small, large] = getReturnValue().map((bytes: number | string) => Number(bytes))
+        expect(small).toBeGreaterThan(0)
+        expect(large).toBeGreaterThan(small)
+
+        // matches the bytes wrapped by buyram
+        const before = getTokenBalance(bob, RAM_SYMBOL)
+        await contracts.system.actions.buyram([bob, wram_contract, `10.0000 EOS`]).send(bob)
+        expect(getTokenBalance(bob, RAM_SYMBOL) - before).toBe(large)
+    })
+
+    test('read_only::quotecost', async () => {
+        await contracts.wram.actions.quotecost([[1024, 10240]]).send()
+        const [small, large] = getReturnValue().map((cost: string) => Asset.from(cost).units.toNumber())
+        expect(small).toBeGreaterThan(0)
+        expect(large).toBeGreaterThan(small)
+    })
+
+    test('read_only::quote::error', async () => {
+        await expectToThrow(
+            contracts.wram.actions.quote([[`1 ${RAM_SYMBOL}`]]).send(),
+            'eosio_assert: symbol precision mismatch'
+        )
+        await expectToThrow(contracts.wram.actions.quotecost([[0]]).send(), 'eosio_assert: must quote positive quantity')
+    })
+
+    test('read_only::getsupply', async () => {
+        await contracts.wram.actions.getsupply([]).send()
+        expect(Asset.from(getReturnValue()).units.toNumber()).toBe(getTokenSupply(RAM_SYMBOL))
+    })
+
+    test('read_only::getstate', async () => {
+        await contracts.wram.actions.getstate([]).send()
+        const { wrap_ram_enabled, unwrap_ram_enabled } = getReturnValue()
+        expect({ wrap_ram_enabled, unwrap_ram_enabled }).toEqual(getConfig())
+    })
+
+    test('cfgsettle::error', async () => {
+        await expectToThrow(contracts.wram.actions.cfgsettle([5000]).send(bob), 'missing required authority eosio.wram')
+        await expectToThrow(
+            contracts.wram.actions.cfgsettle([-1]).send(),
+            'eosio_assert: settle threshold must be positive or zero'
+        )
+    })
+
+    test('settlement - wraps and unwraps are netted until the threshold', async () => {
+        await contracts.wram.actions.cfgsettle([5000]).send()
+        const before = {
+            alice: getRamBytes(alice),
+            wram_contract: getRamBytes(wram_contract),
+            ram_bank: getRamBytes(ram_bank),
+            supply: getTokenSupply(RAM_SYMBOL),
+        }
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 1000, '']).send(alice)
+        expect(getSettlement().pending_bytes).toBe(1000)
+        expect(getRamBytes(ram_bank) - before.ram_bank).toBe(0)
+        expect(getRamBytes(wram_contract) - before.wram_contract).toBe(1000)
+
+        await contracts.wram.actions.unwrap([alice, 400]).send(alice)
+        expect(getSettlement().pending_bytes).toBe(600)
+        expect(getRamBytes(ram_bank) - before.ram_bank).toBe(0)
+        expect(getRamBytes(alice) - before.alice).toBe(-600)
+
+        // supply equals bank bytes plus pending bytes
+        expect(getTokenSupply(RAM_SYMBOL) - before.supply).toBe(600)
+
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 4400, '']).send(alice)
+        expect(getSettlement().pending_bytes).toBe(0)
+        expect(getRamBytes(ram_bank) - before.ram_bank).toBe(5000)
+        expect(getRamBytes(wram_contract) - before.wram_contract).toBe(0)
+    })
+
+    test('settlement - settle', async () => {
+        const before = getRamBytes(ram_bank)
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 700, '']).send(alice)
+        await contracts.wram.actions.settle().send(bob)
+        expect(getSettlement().pending_bytes).toBe(0)
+        expect(getRamBytes(ram_bank) - before).toBe(700)
+
+        await expectToThrow(contracts.wram.actions.settle().send(bob), 'eosio_assert: no pending bytes to settle')
+    })
+
+    test('settlement - disabling settles pending bytes', async () => {
+        const before = getRamBytes(ram_bank)
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 300, '']).send(alice)
+        await contracts.wram.actions.cfgsettle([0]).send()
+        expect(getSettlement()).toEqual({ settle_threshold: 0, pending_bytes: 0 })
+        expect(getRamBytes(ram_bank) - before).toBe(300)
+    })
+
+    test('simulate::simtransfer', async () => {
+        const before = { alice: getTokenBalance(alice, RAM_SYMBOL), supply: getTokenSupply(RAM_SYMBOL) }
+        await contracts.wram.actions.simtransfer([alice, bob, `100 ${RAM_SYMBOL}`, '']).send()
+        const result = getReturnValue()
+        expect(result.success).toBe(true)
+        expect(Asset.from(result.from_balance).units.toNumber()).toBe(before.alice - 100)
+        expect(Asset.from(result.supply).units.toNumber()).toBe(before.supply)
+
+        // no state is changed
+        expect(getTokenBalance(alice, RAM_SYMBOL)).toBe(before.alice)
+    })
+
+    test('simulate::simtransfer::error', async () => {
+        await contracts.wram.actions.simtransfer([alice, egress_list[0], `100 ${RAM_SYMBOL}`, '']).send()
+        expect(getReturnValue()).toMatchObject({ success: false, error: 'transfer disabled to account' })
+
+        await contracts.wram.actions.simtransfer([alice, bob, `${getTokenBalance(alice, RAM_SYMBOL) + 1} ${RAM_SYMBOL}`, '']).send()
+        expect(getReturnValue()).toMatchObject({ success: false, error: 'overdrawn balance' })
+    })
+
+    test('simulate::simunwrap', async () => {
+        const supply = getTokenSupply(RAM_SYMBOL)
+        await contracts.wram.actions.simunwrap([alice, 100]).send()
+        const result = getReturnValue()
+        expect(result.success).toBe(true)
+        expect(Asset.from(result.supply).units.toNumber()).toBe(supply - 100)
+        expect(getTokenSupply(RAM_SYMBOL)).toBe(supply)
+    })
+
+    test('simulate::simwrap', async () => {
+        const supply = getTokenSupply(RAM_SYMBOL)
+        await contracts.wram.actions.simwrap([alice, alice, 100]).send()
+        const result = getReturnValue()
+        expect(result.success).toBe(true)
+        expect(Asset.from(result.to_balance).units.toNumber()).toBe(getTokenBalance(alice, RAM_SYMBOL) + 100)
+        expect(Asset.from(result.supply).units.toNumber()).toBe(supply + 100)
+
+        // `wrap:<account>` memo
+        await contracts.wram.actions.simwrap([alice, charles, 100]).send()
+        expect(Asset.from(getReturnValue().to_balance).units.toNumber()).toBe(getTokenBalance(charles, RAM_SYMBOL) + 100)
+
+        await contracts.wram.actions.simwrap([wram_contract, wram_contract, 100]).send()
+        expect(getReturnValue()).toMatchObject({ success: false, error: 'cannot wrap ram to self' })
+
+        await contracts.wram.actions.simwrap([alice, 'nobody', 100]).send()
+        expect(getReturnValue()).toMatchObject({ success: false, error: 'to account does not exist' })
+    })
+
+    test('return_value::transfer', async () => {
+        await contracts.wram.actions.transfer([alice, bob, `100 ${RAM_SYMBOL}`, '']).send(alice)
+        const result = getActionReturnValue('transfer')
+        expect(Asset.from(result.from_balance).units.toNumber()).toBe(getTokenBalance(alice, RAM_SYMBOL))
+        expect(Asset.from(result.to_balance).units.toNumber()).toBe(getTokenBalance(bob, RAM_SYMBOL))
+
+        // supply is left out of plain transfers, which do not read the `stat` row
+        expect(result.supply ?? null).toBeNull()
+    })
+
+    test('return_value::unwrap', async () => {
+        await contracts.wram.actions.unwrap([alice, 100]).send(alice)
+        const result = getActionReturnValue('unwrap')
+        expect(Asset.from(result.from_balance).units.toNumber()).toBe(getTokenBalance(alice, RAM_SYMBOL))
+        expect(Asset.from(result.supply).units.toNumber()).toBe(getTokenSupply(RAM_SYMBOL))
+        expect(Number(result.bytes)).toBe(100)
+    })
+
+    test('return_value::wrap', async () => {
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 100, '']).send(alice)
+        // receipt transfer sent by the contract carries the result of the wrap
+        const result = getActionReturnValue('transfer')
+        expect(Asset.from(result.to_balance).units.toNumber()).toBe(getTokenBalance(alice, RAM_SYMBOL))
+        expect(Asset.from(result.supply).units.toNumber()).toBe(getTokenSupply(RAM_SYMBOL))
+        expect(Number(result.bytes)).toBe(100)
+    })
+
+    test('on_notify::transfer - buy WRAM with EOS', async () => {
+        await contracts.wram.actions.quote([[`10.0000 EOS`]]).send()
+        const [bytes] = getReturnValue().map((bytes: number | string) => Number(bytes))
+        const before = {
+            bob: getTokenBalance(bob, RAM_SYMBOL),
+            bob_eos: getEosBalance(bob),
+            supply: getTokenSupply(RAM_SYMBOL),
+        }
+        await contracts.token.actions.transfer([bob, wram_contract, `10.0000 EOS`, 'wrap']).send(bob)
+        expect(getTokenBalance(bob, RAM_SYMBOL) - before.bob).toBe(bytes)
+        expect(getEosBalance(bob) - before.bob_eos).toBe(-100000)
+        expect(getTokenSupply(RAM_SYMBOL) - before.supply).toBe(bytes)
+        expect(getPurchase()).toBeUndefined()
+    })
+
+    test('on_notify::transfer - buy WRAM with EOS for another account', async () => {
+        const before = { bob: getTokenBalance(bob, RAM_SYMBOL), charles: getTokenBalance(charles, RAM_SYMBOL) }
+        await contracts.token.actions.transfer([bob, wram_contract, `10.0000 EOS`, `wrap:${charles}`]).send(bob)
+        expect(getTokenBalance(bob, RAM_SYMBOL) - before.bob).toBe(0)
+        expect(getTokenBalance(charles, RAM_SYMBOL) - before.charles).toBeGreaterThan(0)
+        expect(getPurchase()).toBeUndefined()
+    })
+
+    test('on_notify::transfer::error - buy WRAM with EOS', async () => {
+        await expectToThrow(
+            contracts.token.actions.transfer([bob, wram_contract, `10.0000 EOS`, `wrap:${wram_contract}`]).send(bob),
+            'eosio_assert: cannot wrap ram to self'
+        )
+        await expectToThrow(
+            contracts.token.actions.transfer([bob, wram_contract, `10.0000 EOS`, 'wrap:nobody']).send(bob),
+            'eosio_assert: to account does not exist'
+        )
+        await expectToThrow(
+            contracts.token.actions.transfer([bob, wram_contract, `10.0000 EOS`, 'wrapped']).send(bob),
+            'eosio_assert: only eosio.wram token transfers are allowed'
+        )
+        await expectToThrow(
+            contracts.fake.token.actions.transfer([alice, wram_contract, `1000 ${RAM_SYMBOL}`, 'wrap']).send(alice),
+            'eosio_assert: only eosio.wram token transfers are allowed'
+        )
+    })
+
+    test('sellwram', async () => {
+        const before = {
+            alice: getTokenBalance(alice, RAM_SYMBOL),
+            alice_ram: getRamBytes(alice),
+            wram_contract: getRamBytes(wram_contract),
+            ram_bank: getRamBytes(ram_bank),
+            supply: getTokenSupply(RAM_SYMBOL),
+        }
+        await contracts.wram.actions.sellwram([alice, 1000]).send(alice)
+        expect(getTokenBalance(alice, RAM_SYMBOL) - before.alice).toBe(-1000)
+        expect(getTokenSupply(RAM_SYMBOL) - before.supply).toBe(-1000)
+        expect(getRamBytes(ram_bank) - before.ram_bank).toBe(-1000)
+
+        // RAM is sold by the contract, never delivered to the owner
+        expect(getRamBytes(wram_contract) - before.wram_contract).toBe(0)
+        expect(getRamBytes(alice) - before.alice_ram).toBe(0)
+    })
+
+    test('sellwram::error', async () => {
+        await expectToThrow(contracts.wram.actions.sellwram([alice, 1000]).send(bob), 'missing required authority alice')
+        await expectToThrow(contracts.wram.actions.sellwram([alice, 0]).send(alice), 'eosio_assert: must transfer positive quantity')
+        await expectToThrow(
+            contracts.wram.actions.sellwram([alice, getTokenBalance(alice, RAM_SYMBOL) + 1]).send(alice),
+            'eosio_assert: overdrawn balance'
+        )
+        await expectToThrow(
+            contracts.wram.actions.sellpayout([alice, '0.0000 EOS']).send(alice),
+            'missing required authority eosio.wram'
+        )
+    })
+
+    test('unwrapto', async () => {
+        const before = {
+            alice: getTokenBalance(alice, RAM_SYMBOL),
+            alice_ram: getRamBytes(alice),
+            charles_ram: getRamBytes(charles),
+        }
+        await contracts.wram.actions.unwrapto([alice, charles, 500]).send(alice)
+        expect(getTokenBalance(alice, RAM_SYMBOL) - before.alice).toBe(-500)
+        expect(getRamBytes(alice) - before.alice_ram).toBe(0)
+        expect(getRamBytes(charles) - before.charles_ram).toBe(500)
+        expect(Number(getActionReturnValue('unwrapto').bytes)).toBe(500)
+    })
+
+    test('transfer - unwrap memo routes RAM to another account', async () => {
+        const before = { alice_ram: getRamBytes(alice), charles_ram: getRamBytes(charles) }
+        await contracts.wram.actions.transfer([alice, wram_contract, `500 ${RAM_SYMBOL}`, `unwrap:${charles}`]).send(alice)
+        expect(getRamBytes(alice) - before.alice_ram).toBe(0)
+        expect(getRamBytes(charles) - before.charles_ram).toBe(500)
+
+        await contracts.wram.actions.transfer([alice, wram_contract, `500 ${RAM_SYMBOL}`, 'unwrap']).send(alice)
+        expect(getRamBytes(alice) - before.alice_ram).toBe(500)
+    })
+
+    test('unwrapto::error', async () => {
+        await expectToThrow(contracts.wram.actions.unwrapto([alice, charles, 500]).send(bob), 'missing required authority alice')
+        await expectToThrow(
+            contracts.wram.actions.unwrapto([alice, wram_contract, 500]).send(alice),
+            'eosio_assert: cannot unwrap ram to self'
+        )
+        await expectToThrow(
+            contracts.wram.actions.transfer([alice, wram_contract, `500 ${RAM_SYMBOL}`, 'unwrap:nobody']).send(alice),
+            'eosio_assert: to account does not exist'
+        )
+    })
+
+    test('on_notify::ramtransfer - wrap memo mints to another account', async () => {
+        const before = {
+            alice: getTokenBalance(alice, RAM_SYMBOL),
+            charles: getTokenBalance(charles, RAM_SYMBOL),
+            alice_ram: getRamBytes(alice),
+        }
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 1000, `wrap:${charles}`]).send(alice)
+        expect(getTokenBalance(alice, RAM_SYMBOL) - before.alice).toBe(0)
+        expect(getTokenBalance(charles, RAM_SYMBOL) - before.charles).toBe(1000)
+        expect(getRamBytes(alice) - before.alice_ram).toBe(-1000)
+
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 1000, 'wrap']).send(alice)
+        expect(getTokenBalance(alice, RAM_SYMBOL) - before.alice).toBe(1000)
+    })
+
+    test('on_notify::ramtransfer::error - wrap memo', async () => {
+        await expectToThrow(
+            contracts.system.actions.ramtransfer([alice, wram_contract, 1000, `wrap:${wram_contract}`]).send(alice),
+            'eosio_assert: cannot wrap ram to self'
+        )
+        await expectToThrow(
+            contracts.system.actions.ramtransfer([alice, wram_contract, 1000, 'wrap:nobody']).send(alice),
+            'eosio_assert: to account does not exist'
+        )
+    })
+
+    test('apply - ignores transfer notifications not addressed to the contract', async () => {
+        const before = getEosBalance(alice)
+        await contracts.token.actions.transfer([wram_contract, alice, '1.0000 EOS', 'wrap']).send(wram_contract)
+        expect(getEosBalance(alice) - before).toBe(10000)
+    })
+
+    test('errors - codes decode to the contract messages', async () => {
+        await contracts.wram.actions.simtransfer([alice, bob, `${getTokenBalance(alice, RAM_SYMBOL) + 1} ${RAM_SYMBOL}`, '']).send()
+        const { error, error_code } = getReturnValue()
+        expect(WRAM_ERRORS[Number(error_code)]).toBe(error)
+        expect(decodeError(`eosio_assert_code: ${error_code}`)).toBe('overdrawn balance')
+        expect(decodeError('eosio_assert: overdrawn balance')).toBe('eosio_assert: overdrawn balance')
+    })
+
+    test('wrap - every wrap sends a transfer receipt to the recipient', async () => {
+        const wraps: [string, () => Promise<unknown>][] = [
+            [alice, () => contracts.system.actions.ramtransfer([alice, wram_contract, 100, '']).send(alice)],
+            [charles, () => contracts.system.actions.ramtransfer([alice, wram_contract, 100, `wrap:${charles}`]).send(alice)],
+            [alice, () => contracts.system.actions.buyrambytes([alice, wram_contract, 100]).send(alice)],
+            [bob, () => contracts.token.actions.transfer([bob, wram_contract, `1.0000 EOS`, 'wrap']).send(bob)],
+            [charles, () => contracts.token.actions.transfer([bob, wram_contract, `1.0000 EOS`, `wrap:${charles}`]).send(bob)],
+        ]
+        for (const [recipient, wrap] of wraps) {
+            const before = getTokenBalance(recipient, RAM_SYMBOL)
+            await wrap()
+            const receipts = getReceipts(recipient)
+            expect(receipts.length).toBe(1)
+            expect(Asset.from(receipts[0].quantity).units.toNumber()).toBe(getTokenBalance(recipient, RAM_SYMBOL) - before)
+        }
+    })
+
+    test('wrap - the contract balance row is never touched', async () => {
+        expect(hasTokenRow(wram_contract, RAM_SYMBOL)).toBe(false)
+
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 100, '']).send(alice)
+        await contracts.system.actions.buyrambytes([alice, wram_contract, 100]).send(alice)
+        await contracts.token.actions.transfer([bob, wram_contract, `1.0000 EOS`, 'wrap']).send(bob)
+        await contracts.wram.actions.unwrap([alice, 100]).send(alice)
+        expect(hasTokenRow(wram_contract, RAM_SYMBOL)).toBe(false)
+    })
+
+    test('refundbatch - returns an undistributed deposit while wrapping is disabled', async () => {
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 500, 'batch']).send(alice)
+        const deposit = getDeposit(alice)
+        const before = { alice: getRamBytes(alice), supply: getTokenSupply(RAM_SYMBOL) }
+
+        await contracts.wram.actions.cfg([false, true]).send()
+        await contracts.wram.actions.refundbatch([alice]).send(alice)
+        expect(getRamBytes(alice) - before.alice).toBe(deposit)
+        expect(getTokenSupply(RAM_SYMBOL)).toBe(before.supply)
+        expect(getDeposit(alice)).toBe(0)
+        await contracts.wram.actions.cfg([true, true]).send()
+    })
+
+    test('refundbatch::error', async () => {
+        await contracts.system.actions.ramtransfer([alice, wram_contract, 500, 'batch']).send(alice)
+        await expectToThrow(contracts.wram.actions.refundbatch([alice]).send(bob), 'missing required authority alice')
+        await contracts.wram.actions.refundbatch([alice]).send(alice)
+        await expectToThrow(contracts.wram.actions.refundbatch([alice]).send(alice), 'eosio_assert: no ram deposit found')
+    })
+
+    test('initstate', async () => {
+        const before = getState()
+        await contracts.wram.actions.initstate().send()
+        expect(getState()).toEqual(before)
+        expect(contracts.wram.tables.config(Name.from(wram_contract).value.value).getTableRows()).toEqual([])
+
+        await expectToThrow(contracts.wram.actions.initstate().send(bob), 'missing required authority eosio.wram')
+    })
+
+    test('sendmany::error - cannot send to egress list', async () => {
+        await contracts.wram.actions.addegress([egress_list]).send(wram_contract)
+        await expectToThrow(
+            contracts.wram.actions
+                .sendmany([
+                    alice,
+                    [
+                        { to: bob, quantity: `1 ${RAM_SYMBOL}`, memo: '' },
+                        { to: egress_list[0], quantity: `1 ${RAM_SYMBOL}`, memo: '' },
+                    ],
+                ])
+                .send(alice),
+            'eosio_assert: transfer disabled to account'
+        )
+        await contracts.wram.actions.removeegress([egress_list]).send(wram_contract)
+    })
+
+    test('memo::error - invalid account in memo', async () => {
+        for (const memo of ['unwrap:Bob', 'unwrap:', 'unwrap:accountname123']) {
+            await contracts.wram.actions.simtransfer([alice, wram_contract, `1 ${RAM_SYMBOL}`, memo]).send()
+            expect(getReturnValue()).toMatchObject({ success: false, error: 'invalid account in memo' })
+        }
+        await expectToThrow(
+            contracts.wram.actions.transfer([alice, wram_contract, `1 ${RAM_SYMBOL}`, 'unwrap:Bob']).send(alice),
+            'eosio_assert: invalid account in memo'
+        )
+        await expectToThrow(
+            contracts.system.actions.ramtransfer([alice, wram_contract, 1000, 'wrap:Bob']).send(alice),
+            'eosio_assert: invalid account in memo'
+        )
+        await expectToThrow(
+            contracts.token.actions.transfer([bob, wram_contract, `1.0000 EOS`, 'wrap:b@b']).send(bob),
+            'eosio_assert: invalid account in memo'
+        )
+    })
+
+    test('errors - lookups fail with codes', async () => {
+        expect(decodeError('eosio_assert_code: 42')).toBe('no ram deposit found')
+        expect(decodeError('eosio_assert_code: 43')).toBe('symbol does not exist')
+        expect(decodeError('eosio_assert_code: 44')).toBe('ram market does not exist')
+        expect(decodeError('eosio_assert_code: 45')).toBe('invalid action data')
+
+        await expectToThrow(contracts.wram.actions.refundbatch([charles]).send(charles), 'eosio_assert: no ram deposit found')
+    })
 })
@@ -0,0 +1,41 @@
+import { Blockchain } from '@eosnetwork/vert'
+import { describe, expect, test } from 'bun:test'
+import { existsSync, readFileSync } from 'fs'
+import { WRAM_ERRORS, decodeError } from './errors'
+
+// contract built with `-DWRAM_ERROR_CODES` by `npm run build:codes`
+const codes_contract = 'build/codes/eosio.wram'
+
+async function getError(action: Promise<unknown>) {
+    try {
+        await action
+    } catch (error) {
+        return (error as Error).message
+    }
+    throw new Error('action did not fail')
+}
+
+describe('errors', () => {
+    test('errors.ts - matches the messages of src/errors.hpp', () => {
+        const header = readFileSync('src/errors.hpp', 'utf8')
+        const table = header.slice(header.indexOf('wram_error_messages[]'), header.indexOf('};', header.indexOf('wram_error_messages[]')))
+        const messages = [...table.matchAll(/^\s*"(.*)",$/gm)].map(([, message]) => message)
+        expect(messages[0]).toBe('')
+        expect(messages.slice(1)).toEqual(Object.keys(WRAM_ERRORS).map((code) => WRAM_ERRORS[Number(code)]))
+    })
+
+    test('decodeError - nodeos and vert messages', () => {
+        expect(decodeError('assertion failure with error code: 20')).toBe('overdrawn balance')
+        expect(decodeError('eosio_assert_code: 20')).toBe('overdrawn balance')
+        expect(decodeError('eosio_assert: overdrawn balance')).toBe('eosio_assert: overdrawn balance')
+    })
+
+    test.skipIf(!existsSync(`${codes_contract}.wasm`))('build:codes - failing checks abort with a decodable code', async () => {
+        const blockchain = new Blockchain()
+        const wram = blockchain.createContract('eosio.wram', codes_contract, true)
+
+        const message = await getError(wram.actions.cfgsettle([-1]).send())
+        expect(message).not.toContain('settle threshold')
+        expect(decodeError(message)).toBe('settle threshold must be positive or zero')
+    })
+})
@@ -0,0 +1,57 @@
+// Messages of the numeric error codes raised by a contract built with `-DWRAM_ERROR_CODES`,
+// kept in sync with `src/errors.hpp`
+export const WRAM_ERRORS: Record<number, string> = {
+    1: 'invalid supply',
+    2: 'max-supply must be positive',
+    3: 'token with symbol already exists',
+    4: 'symbol must be WRAM',
+    5: 'invalid symbol name',
+    6: 'memo has more than 256 bytes',
+    7: 'tokens can only be issued to issuer account',
+    8: 'must be executed by contract',
+    9: 'invalid quantity',
+    10: 'must issue positive quantity',
+    11: 'symbol precision mismatch',
+    12: 'must retire positive quantity',
+    13: 'cannot transfer to self',
+    14: 'must transfer positive quantity',
+    15: 'unwrap ram is currently disabled',
+    16: 'cannot unwrap ram to self',
+    17: 'to account does not exist',
+    18: 'transfer disabled to account',
+    19: 'no balance object found',
+    20: 'overdrawn balance',
+    21: 'transfers cannot be empty',
+    22: 'cannot unwrap with sendmany',
+    23: 'quantity exceeds available supply',
+    24: 'owner account does not exist',
+    25: 'Balance row already deleted or never existed. Action won't have any effect.',
+    26: 'Cannot close because the balance is not zero.',
+    27: 'Only the system WRAM token is accepted for transfers.',
+    28: 'cannot wrap ram to self',
+    29: 'wrap ram is currently disabled',
+    30: 'only eosio.wram token transfers are allowed',
+    31: 'can only be executed once',
+    32: 'purchase already pending',
+    33: 'recipients cannot be empty',
+    34: 'recipients exceed ram deposit',
+    35: 'owners cannot be empty',
+    36: 'settle threshold must be positive or zero',
+    37: 'no pending bytes to settle',
+    38: 'must quote positive quantity',
+    39: 'quantity exceeds ram market reserve',
+    40: 'unknown action',
+    41: 'invalid account in memo',
+    42: 'no ram deposit found',
+    43: 'symbol does not exist',
+    44: 'ram market does not exist',
+    45: 'invalid action data',
+}
+
+// `assertion failure with error code: 20` (nodeos) or `eosio_assert_code: 20` (vert) => 'overdrawn balance',
+// any other message is returned as is
+export function decodeError(message: string): string {
+    const match = /(?:assertion failure with error code|eosio_assert_code): (\d+)/.exec(message)
+    if (!match) return message
+    return WRAM_ERRORS[Number(match[1])] ?? message
+}
@@ -0,0 +1,15 @@
+#!/usr/bin/env bash
+# Lean build of the contract at a git ref (default `HEAD^`) into build/baseline, compared against by `bench` & the `size` budget
+#
+# bash scripts/baseline.sh [git ref]
+set -euo pipefail
+
+ref="${1:-${WRAM_BASELINE_REF:-HEAD^}}"
+worktree="$(mktemp -d)/eosio.wram"
+git worktree add --detach "$worktree" "$ref"
+trap 'git worktree remove --force "$worktree"' EXIT
+
+mkdir -p build/baseline
+cdt-cpp "$worktree/eosio.wram.cpp" -I "$worktree/include" -Os -R ./build/baseline --no-missing-ricardian-clause -o build/baseline/eosio.wram.wasm
+wasm-opt -Oz --mvp-features --strip-dwarf --strip-producers build/baseline/eosio.wram.wasm -o build/baseline/eosio.wram.wasm
+echo "build/baseline/eosio.wram.wasm: $(git rev-parse --short "$ref")"
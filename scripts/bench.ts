@@ -0,0 +1,89 @@
+// Execution time of the hot actions of a build next to a baseline build (see `scripts/baseline.sh`)
+//
+// bun scripts/bench.ts [contract path without extension] [baseline path without extension] [runs per action]
+//
+// Times are the wall clock of a `send` in the vert VM, client-side serialization included. Both builds run
+// the same actions one after the other in the same process, so that overhead is shared by both columns.
+import { AccountPermission, Blockchain } from '@eosnetwork/vert'
+import { Name, Authority, PermissionLevel } from '@greymass/eosio'
+
+const [path = 'build/lean/eosio.wram', baseline = 'build/baseline/eosio.wram', runs = '200'] = process.argv.slice(2)
+
+const wram_contract = 'eosio.wram'
+const ram_bank = 'ramdeposit11'
+const [alice, bob, charles] = ['alice', 'bob', 'charles']
+
+type Actions = Record<string, () => Promise<unknown>>
+
+async function setup(contract: string): Promise<Actions> {
+    const blockchain = new Blockchain()
+    blockchain.createAccounts(alice, bob, charles, ram_bank)
+
+    const wram = blockchain.createContract(wram_contract, contract, true)
+    const token = blockchain.createContract('eosio.token', 'external/eosio.token/eosio.token', true)
+    const system = blockchain.createContract('eosio', 'external/eosio.system/eosio', true)
+
+    blockchain.getAccount(Name.from(ram_bank))?.setPermissions([
+        AccountPermission.from({
+            perm_name: Name.from('active'),
+            parent: Name.from('owner'),
+            required_auth: Authority.from({
+                threshold: 1,
+                accounts: [{ weight: 1, permission: PermissionLevel.from('eosio.wram@eosio.code') }],
+            }),
+        }),
+    ])
+
+    await system.actions.init([]).send()
+    await token.actions.create(['eosio.token', '1000000000.0000 EOS']).send()
+    await token.actions.issue(['eosio.token', '1000000000.0000 EOS', '']).send()
+    await token.actions.transfer(['eosio.token', alice, '100000.0000 EOS', '']).send()
+    await wram.actions.create([wram_contract, '418945440768 WRAM']).send()
+    await wram.actions.cfg([true, true]).send()
+    await system.actions.buyrambytes([alice, alice, 10000000]).send()
+    await system.actions.ramtransfer([alice, wram_contract, 5000000, '']).send(alice)
+
+    return {
+        'ramtransfer (wrap)': () => system.actions.ramtransfer([alice, wram_contract, 100, '']).send(alice),
+        'buyrambytes (wrap)': () => system.actions.buyrambytes([alice, wram_contract, 100]).send(alice),
+        'eosio.token::transfer (wrap)': () => token.actions.transfer([alice, wram_contract, '0.0100 EOS', 'wrap']).send(alice),
+        transfer: () => wram.actions.transfer([alice, bob, '100 WRAM', '']).send(alice),
+        'transfer (unwrap)': () => wram.actions.transfer([alice, wram_contract, '100 WRAM', '']).send(alice),
+        unwrap: () => wram.actions.unwrap([alice, 100]).send(alice),
+        sendmany: () =>
+            wram.actions
+                .sendmany([
+                    alice,
+                    [
+                        { to: bob, quantity: '100 WRAM', memo: '' },
+                        { to: charles, quantity: '100 WRAM', memo: '' },
+                    ],
+                ])
+                .send(alice),
+    }
+}
+
+// mean microseconds of a run, undefined when the build does not support the action
+async function time(action: () => Promise<unknown>, count: number) {
+    try {
+        await action() // first run creates the balance rows
+    } catch {
+        return undefined
+    }
+    const start = performance.now()
+    for (let i = 0; i < count; i++) await action()
+    return ((performance.now() - start) * 1000) / count
+}
+
+const head = await setup(path)
+const base = await setup(baseline)
+const format = (us?: number) => (us === undefined ? 'n/a' : `${us.toFixed(0)} us`).padStart(10)
+
+console.log(`${path}.wasm against ${baseline}.wasm: mean of ${runs} runs`)
+console.log(`${'head'.padStart(10)}${'baseline'.padStart(10)}${'change'.padStart(10)}`)
+for (const name of Object.keys(head)) {
+    const after = await time(head[name], Number(runs))
+    const before = await time(base[name], Number(runs))
+    const change = after !== undefined && before !== undefined ? `${(((after - before) / before) * 100).toFixed(1)}%` : 'n/a'
+    console.log(`${format(after)}${format(before)}${change.padStart(10)}  ${name}`)
+}
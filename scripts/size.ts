@@ -0,0 +1,117 @@
+// Size report of a built contract: section & per-function code size, fails when the wasm exceeds the budget.
+// Function names are read from the `name` section, kept by `--strip-dwarf`
+//
+// The budget is `WRAM_SIZE_BUDGET` bytes if set, else the baseline build (see `scripts/baseline.sh`) plus
+// `config.size_margin` bytes of package.json. Without either, CI fails instead of skipping the check.
+//
+// bun scripts/size.ts [contract path without extension] [number of functions to list]
+import { config } from '../package.json'
+
+const [path = 'build/lean/eosio.wram', top = '25'] = process.argv.slice(2)
+const baseline = Bun.file('build/baseline/eosio.wram.wasm')
+const budget = process.env.WRAM_SIZE_BUDGET
+    ? Number(process.env.WRAM_SIZE_BUDGET)
+    : (await baseline.exists())
+      ? baseline.size + config.size_margin
+      : undefined
+if (budget === undefined && process.env.CI) {
+    console.error('no size budget: run `build:baseline` first or set WRAM_SIZE_BUDGET')
+    process.exit(1)
+}
+
+const wasm = new Uint8Array(await Bun.file(`${path}.wasm`).arrayBuffer())
+const abi = await Bun.file(`${path}.abi`).text()
+
+let offset = 8 // magic & version
+function leb128() {
+    let result = 0
+    let shift = 0
+    let byte
+    do {
+        byte = wasm[offset++]
+        result += (byte & 0x7f) * 2 ** shift
+        shift += 7
+    } while (byte & 0x80)
+    return result
+}
+function text() {
+    const length = leb128()
+    const value = new TextDecoder().decode(wasm.subarray(offset, offset + length))
+    offset += length
+    return value
+}
+
+const SECTIONS = ['custom', 'type', 'import', 'function', 'table', 'memory', 'global', 'export', 'start', 'element', 'code', 'data']
+const sections: Record<string, number> = {}
+const bodies: number[] = []
+const names = new Map<number, string>()
+let imported = 0
+
+while (offset < wasm.length) {
+    const id = wasm[offset++]
+    const size = leb128()
+    const end = offset + size
+    let name = SECTIONS[id] ?? `unknown ${id}`
+
+    if (id === 0) {
+        name = `custom "${text()}"`
+        if (name === 'custom "name"') {
+            while (offset < end) {
+                const subsection = wasm[offset++]
+                const subsection_end = leb128() + offset
+                if (subsection === 1) {
+                    for (let count = leb128(); count > 0; count--) {
+                        const index = leb128()
+                        names.set(index, text())
+                    }
+                }
+                offset = subsection_end
+            }
+        }
+    } else if (id === 2) {
+        for (let count = leb128(); count > 0; count--) {
+            text() // module
+            text() // field
+            const kind = wasm[offset++]
+            if (kind === 0) {
+                imported++
+                leb128()
+            } else if (kind === 1) {
+                offset++
+                if (wasm[offset++] & 1) leb128()
+                leb128()
+            } else if (kind === 2) {
+                if (wasm[offset++] & 1) leb128()
+                leb128()
+            } else {
+                offset += 2
+            }
+        }
+    } else if (id === 10) {
+        for (let count = leb128(); count > 0; count--) {
+            const body = leb128()
+            bodies.push(body)
+            offset += body
+        }
+    }
+    sections[name] = (sections[name] ?? 0) + size
+    offset = end
+}
+
+console.log(`${path}.wasm: ${wasm.length} bytes${budget ? ` (budget ${budget})` : ''}`)
+console.log(`${path}.abi: ${abi.length} bytes\n`)
+for (const [name, size] of Object.entries(sections).sort((a, b) => b[1] - a[1])) {
+    console.log(`${String(size).padStart(8)}  ${name}`)
+}
+
+console.log(`\ntop ${top} of ${bodies.length} functions`)
+bodies
+    .map((size, i) => ({ size, name: names.get(imported + i) ?? `func[${imported + i}]` }))
+    .sort((a, b) => b.size - a.size)
+    .slice(0, Number(top))
+    .forEach(({ size, name }) => console.log(`${String(size).padStart(8)}  ${name}`))
+
+if (budget && wasm.length > budget) {
+    console.error(`\n${path}.wasm exceeds the size budget by ${wasm.length - budget} bytes`)
+    process.exit(1)
+}
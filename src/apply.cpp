@@ -0,0 +1,174 @@
+#include <tuple>
+#include <type_traits>
+
+extern "C" {
+   __attribute__((eosio_wasm_import))
+   void set_action_return_value( void* return_value, size_t size );
+}
+
+namespace eosio {
+
+constexpr size_t max_stack_buffer_size = 512;
+
+// pack `value` on the stack as the action return value
+template<typename T>
+void return_value( const T& value )
+{
+   const size_t size = pack_size(value);
+   void* buffer = max_stack_buffer_size < size ? malloc(size) : alloca(size);
+
+   datastream<char*> ds((char*)buffer, size);
+   ds << value;
+   ::set_action_return_value(buffer, size);
+
+   if (max_stack_buffer_size < size) free(buffer);
+}
+
+// decode the action data, run `func` and pack its result as the action return value
+template<typename R, typename... Args>
+void execute( const name receiver, const name code, R (wram::*func)(Args...) )
+{
+   const size_t size = action_data_size();
+   void* buffer = nullptr;
+   if (size > 0) {
+      buffer = max_stack_buffer_size < size ? malloc(size) : alloca(size);
+      read_action_data(buffer, size);
+   }
+
+   std::tuple<std::decay_t<Args>...> args;
+   datastream<const char*> ds((char*)buffer, size);
+   ds >> args;
+
+   wram inst(receiver, code, ds);
+   if constexpr (std::is_void_v<R>) {
+      std::apply([&](auto&... a) { (inst.*func)(a...); }, args);
+   } else {
+      return_value(std::apply([&](auto&... a) { return (inst.*func)(a...); }, args));
+   }
+
+   if (max_stack_buffer_size < size) free(buffer);
+}
+
+/**
+ * `transfer` & `ramtransfer` payload `(name, name, Amount, string)` decoded into a stack buffer,
+ * the memo is a view into that buffer instead of a heap allocated `string`.
+ */
+template<typename Amount>
+struct memo_payload {
+   char           buffer[max_stack_buffer_size];
+   size_t         size = 0;
+   name           from;
+   name           to;
+   Amount         amount;
+   string_view    memo;
+
+   // false when the payload does not fit the buffer, decode with `execute` instead
+   bool read()
+   {
+      size = action_data_size();
+      if (size > sizeof(buffer)) return false;
+      read_action_data(buffer, size);
+
+      datastream<const char*> ds(buffer, size);
+      unsigned_int length;
+      ds >> from >> to >> amount >> length;
+      check(length.value <= ds.remaining(), wram_error::invalid_action_data);
+      memo = string_view{ds.pos(), length.value};
+      return true;
+   }
+
+   wram contract( const name receiver, const name code ) const
+   {
+      return wram(receiver, code, datastream<const char*>(buffer, size));
+   }
+};
+
+// `transfer`, `ramtransfer` & `logbuyram` all start with (name, name), the second being the recipient
+bool is_addressed_to( const name receiver )
+{
+   uint64_t accounts[2] = {0, 0};
+   read_action_data(accounts, sizeof(accounts));
+   return accounts[1] == receiver.value;
+}
+
+} /// namespace eosio
+
+extern "C" {
+   [[eosio::wasm_entry]]
+   void apply( uint64_t receiver, uint64_t code, uint64_t action )
+   {
+      using namespace eosio;
+      const name self{receiver};
+      const name contract{code};
+
+      // notifications, skipped before decoding anything when not addressed to this contract
+      if (contract != self) {
+         switch (action) {
+            case "transfer"_n.value:
+               if (!is_addressed_to(self)) return;
+
+               // only EOS is accepted, reject any other token without decoding the memo
+               check(contract == wram::EOS_CONTRACT, wram_error::only_wram_transfers_allowed);
+               if (memo_payload<asset> payload; payload.read()) {
+                  return payload.contract(self, contract).on_transfer_view(payload.from, payload.to, payload.amount, payload.memo);
+               }
+               return execute(self, contract, &wram::on_transfer);
+            case "ramtransfer"_n.value:
+               if (contract != "eosio"_n || !is_addressed_to(self)) return;
+               if (memo_payload<int64_t> payload; payload.read()) {
+                  return payload.contract(self, contract).on_ramtransfer_view(payload.from, payload.to, payload.amount, payload.memo);
+               }
+               return execute(self, contract, &wram::on_ramtransfer);
+            case "logbuyram"_n.value:
+               if (contract != "eosio"_n || !is_addressed_to(self)) return;
+               return execute(self, contract, &wram::on_logbuyram);
+         }
+         return;
+      }
+
+      switch (action) {
+         // token
+         case "transfer"_n.value:
+            if (memo_payload<asset> payload; payload.read()) {
+               return return_value(payload.contract(self, contract).transfer_view(payload.from, payload.to, payload.amount, payload.memo));
+            }
+            return execute(self, contract, &wram::transfer);
+         case "sendmany"_n.value:     return execute(self, contract, &wram::sendmany);
+         case "open"_n.value:         return execute(self, contract, &wram::open);
+         case "close"_n.value:        return execute(self, contract, &wram::close);
+         case "create"_n.value:       return execute(self, contract, &wram::create);
+         case "issue"_n.value:        return execute(self, contract, &wram::issue);
+         case "retire"_n.value:       return execute(self, contract, &wram::retire);
+
+         // wrap & unwrap
+         case "unwrap"_n.value:       return execute(self, contract, &wram::unwrap);
+         case "unwrapto"_n.value:     return execute(self, contract, &wram::unwrapto);
+         case "unwrapbatch"_n.value:  return execute(self, contract, &wram::unwrapbatch);
+         case "wrapbatch"_n.value:    return execute(self, contract, &wram::wrapbatch);
+         case "refundbatch"_n.value:  return execute(self, contract, &wram::refundbatch);
+         case "sellwram"_n.value:     return execute(self, contract, &wram::sellwram);
+         case "sellpayout"_n.value:   return execute(self, contract, &wram::sellpayout);
+         case "settle"_n.value:       return execute(self, contract, &wram::settle);
+
+         // admin
+         case "cfg"_n.value:          return execute(self, contract, &wram::cfg);
+         case "cfgsettle"_n.value:    return execute(self, contract, &wram::cfgsettle);
+         case "addegress"_n.value:    return execute(self, contract, &wram::addegress);
+         case "removeegress"_n.value: return execute(self, contract, &wram::removeegress);
+         case "migrate"_n.value:      return execute(self, contract, &wram::migrate);
+         case "initstate"_n.value:    return execute(self, contract, &wram::initstate);
+
+         // read-only
+         case "getbalance"_n.value:   return execute(self, contract, &wram::getbalance);
+         case "getbalances"_n.value:  return execute(self, contract, &wram::getbalances);
+         case "getsupply"_n.value:    return execute(self, contract, &wram::getsupply);
+         case "getstate"_n.value:     return execute(self, contract, &wram::getstate);
+         case "quote"_n.value:        return execute(self, contract, &wram::quote);
+         case "quotecost"_n.value:    return execute(self, contract, &wram::quotecost);
+         case "simtransfer"_n.value:  return execute(self, contract, &wram::simtransfer);
+         case "simunwrap"_n.value:    return execute(self, contract, &wram::simunwrap);
+         case "simwrap"_n.value:      return execute(self, contract, &wram::simwrap);
+      }
+      check(false, wram_error::unknown_action);
+   }
+}
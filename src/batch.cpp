@@ -0,0 +1,96 @@
+namespace eosio {
+
+[[eosio::action]]
+void wram::wrapbatch( const name owner, const vector<batch_entry> recipients )
+{
+   require_auth(owner);
+   check(!recipients.empty(), wram_error::recipients_cannot_be_empty);
+
+   // check status
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   check(get_state(ctx).wrap_ram_enabled, wram_error::wrap_ram_disabled);
+
+   deposits _deposits(get_self(), get_self().value);
+   auto deposit = _deposits.find(owner.value);
+   check(deposit != _deposits.end(), wram_error::no_ram_deposit_found);
+
+   // credit every recipient, supply and rambank are updated once for the whole batch
+   int64_t bytes = 0;
+   for (const batch_entry& entry : recipients) {
+      check(entry.bytes > 0, wram_error::must_transfer_positive_quantity);
+      check(entry.bytes <= deposit->bytes - bytes, wram_error::recipients_exceed_ram_deposit);
+      check(entry.account != get_self(), wram_error::cannot_wrap_ram_to_self);
+      check(is_account(entry.account), wram_error::to_account_does_not_exist);
+      check_disable_transfer(ctx, entry.account);
+
+      add_balance(entry.account, asset{entry.bytes, RAM_SYMBOL}, get_self());
+      bytes += entry.bytes;
+   }
+
+   if (bytes == deposit->bytes) {
+      _deposits.erase(deposit);
+   } else {
+      _deposits.modify(deposit, same_payer, [&](auto& row) {
+         row.bytes -= bytes;
+      });
+   }
+
+   mint(ctx, asset{bytes, RAM_SYMBOL});
+
+   // ramtransfer to rambank
+   send_to_bank(ctx, bytes);
+   save_context(ctx);
+
+   // transfer receipts only, balances are already credited by mint
+   for (const batch_entry& entry : recipients) {
+      send_transfer(get_self(), entry.account, asset{entry.bytes, RAM_SYMBOL}, "wrap ram");
+   }
+}
+
+[[eosio::action]]
+void wram::refundbatch( const name owner )
+{
+   require_auth(owner);
+
+   // deposits are held by the contract itself, not counted in pending bytes
+   deposits _deposits(get_self(), get_self().value);
+   auto deposit = _deposits.find(owner.value);
+   check(deposit != _deposits.end(), wram_error::no_ram_deposit_found);
+
+   send_ramtransfer(get_self(), owner, deposit->bytes, "refund ram");
+   _deposits.erase(deposit);
+}
+
+[[eosio::action]]
+void wram::unwrapbatch( const vector<batch_entry> owners )
+{
+   check(!owners.empty(), wram_error::owners_cannot_be_empty);
+
+   // check status once for the whole batch
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   check(get_state(ctx).unwrap_ram_enabled, wram_error::unwrap_ram_disabled);
+
+   // debit every owner, merging repeated owners into a single ramtransfer
+   map<name, int64_t> payouts;
+   int64_t bytes = 0;
+   for (const batch_entry& entry : owners) {
+      require_auth(entry.account);
+      check(entry.bytes > 0, wram_error::must_transfer_positive_quantity);
+
+      sub_balance(entry.account, asset{entry.bytes, RAM_SYMBOL});
+      require_recipient(entry.account);
+      payouts[entry.account] += entry.bytes;
+      bytes += entry.bytes;
+   }
+
+   // burn wram, already debited from the owners
+   burn(ctx, asset{bytes, RAM_SYMBOL});
+
+   // ramtransfer to owners
+   for (const auto& [owner, amount] : payouts) {
+      send_from_bank(ctx, owner, amount);
+   }
+   save_context(ctx);
+}
+
+} /// namespace eosio
@@ -4,11 +4,36 @@ namespace eosio {
     {
         require_auth(get_self());
 
-        config_table _config(get_self(), get_self().value);
-        config_row config = _config.get_or_default();
+        context ctx{get_self(), RAM_SYMBOL.code()};
+        state_row& state = get_state(ctx);
 
-        config.wrap_ram_enabled = wrap_ram_enabled;
-        config.unwrap_ram_enabled = unwrap_ram_enabled;
-        _config.set(config, get_self());
+        state.wrap_ram_enabled = wrap_ram_enabled;
+        state.unwrap_ram_enabled = unwrap_ram_enabled;
+        ctx.state_changed = true;
+        save_context(ctx);
     }
-}
\ No newline at end of file
+
+    void wram::cfgsettle( const int64_t settle_threshold )
+    {
+        require_auth(get_self());
+        check(settle_threshold >= 0, wram_error::settle_threshold_must_be_positive);
+
+        context ctx{get_self(), RAM_SYMBOL.code()};
+        state_row& state = get_state(ctx);
+
+        state.settle_threshold = settle_threshold;
+        if (settle_threshold == 0 && state.pending_bytes > 0) settle_pending(ctx);
+        ctx.state_changed = true;
+        save_context(ctx);
+    }
+
+    void wram::initstate()
+    {
+        require_auth(get_self());
+
+        context ctx{get_self(), RAM_SYMBOL.code()};
+        get_state(ctx);
+        ctx.state_changed = true;
+        save_context(ctx);
+    }
+}
@@ -4,6 +4,8 @@ namespace eosio {
     {
         require_auth(get_self());
 
+        context ctx{get_self(), RAM_SYMBOL.code()};
+        state_row& state = get_state(ctx);
         egresslist _egresslist(get_self(), get_self().value);
 
         for (const name account : accounts) {
@@ -12,7 +14,10 @@ namespace eosio {
             _egresslist.emplace(get_self(), [&](auto& row) {
                 row.account = account;
             });
+            state.egress.insert(std::lower_bound(state.egress.begin(), state.egress.end(), account), account);
         }
+        ctx.state_changed = true;
+        save_context(ctx);
     }
 
     [[eosio::action]]
@@ -20,22 +25,32 @@ namespace eosio {
     {
         require_auth(get_self());
 
+        context ctx{get_self(), RAM_SYMBOL.code()};
+        state_row& state = get_state(ctx);
         egresslist _egresslist(get_self(), get_self().value);
 
         for (const name account : accounts) {
             auto itr = _egresslist.find(account.value);
             if (itr == _egresslist.end() ) continue; // skip if not exists
             _egresslist.erase(itr);
+            auto pos = std::lower_bound(state.egress.begin(), state.egress.end(), account);
+            if (pos != state.egress.end() && *pos == account) state.egress.erase(pos);
         }
+        ctx.state_changed = true;
+        save_context(ctx);
     }
 
     // block transfers to any account in the egress list
-    void wram::check_disable_transfer( const name receiver )
+    void wram::check_disable_transfer( context& ctx, const name receiver )
     {
-        if (receiver == get_self()) { return; } // ignore self transfer (eosio.wram)
+        check( !is_egress(ctx, receiver), wram_error::transfer_disabled_to_account );
+    }
 
-        egresslist _egresslist(get_self(), get_self().value);
-        auto itr = _egresslist.find(receiver.value);
-        check( itr == _egresslist.end(), "transfer disabled to account" );
+    bool wram::is_egress( context& ctx, const name receiver )
+    {
+        if (receiver == get_self()) { return false; } // ignore self transfer (eosio.wram)
+
+        const vector<name>& egress = get_state(ctx).egress;
+        return std::binary_search(egress.begin(), egress.end(), receiver);
     }
-}
\ No newline at end of file
+}
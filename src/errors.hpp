@@ -0,0 +1,133 @@
+#pragma once
+
+namespace eosio {
+   /**
+    * Error codes of the contract, the message text is only materialized when a check fails.
+    *
+    * Built with `-DWRAM_ERROR_CODES` a failing check aborts with the numeric code (`eosio_assert_code`)
+    * and no message text is linked into the contract, clients map codes back with `errors.ts`.
+    */
+   enum class wram_error : uint64_t {
+      none                                = 0,
+      invalid_supply                      = 1,
+      max_supply_must_be_positive         = 2,
+      token_already_exists                = 3,
+      symbol_must_be_wram                 = 4,
+      invalid_symbol_name                 = 5,
+      memo_too_long                       = 6,
+      issue_to_issuer_only                = 7,
+      must_be_executed_by_contract        = 8,
+      invalid_quantity                    = 9,
+      must_issue_positive_quantity        = 10,
+      symbol_precision_mismatch           = 11,
+      must_retire_positive_quantity       = 12,
+      cannot_transfer_to_self             = 13,
+      must_transfer_positive_quantity     = 14,
+      unwrap_ram_disabled                 = 15,
+      cannot_unwrap_ram_to_self           = 16,
+      to_account_does_not_exist           = 17,
+      transfer_disabled_to_account        = 18,
+      no_balance_object_found             = 19,
+      overdrawn_balance                   = 20,
+      transfers_cannot_be_empty           = 21,
+      cannot_unwrap_with_sendmany         = 22,
+      quantity_exceeds_available_supply   = 23,
+      owner_account_does_not_exist        = 24,
+      balance_row_not_found               = 25,
+      balance_not_zero                    = 26,
+      only_system_wram_accepted           = 27,
+      cannot_wrap_ram_to_self             = 28,
+      wrap_ram_disabled                   = 29,
+      only_wram_transfers_allowed         = 30,
+      can_only_be_executed_once           = 31,
+      purchase_already_pending            = 32,
+      recipients_cannot_be_empty          = 33,
+      recipients_exceed_ram_deposit       = 34,
+      owners_cannot_be_empty              = 35,
+      settle_threshold_must_be_positive   = 36,
+      no_pending_bytes_to_settle          = 37,
+      must_quote_positive_quantity        = 38,
+      quantity_exceeds_ram_market_reserve = 39,
+      unknown_action                      = 40,
+      invalid_memo_account                = 41,
+      no_ram_deposit_found                = 42,
+      symbol_does_not_exist               = 43,
+      ram_market_does_not_exist           = 44,
+      invalid_action_data                 = 45,
+   };
+
+   // indexed by `wram_error`, kept in sync with `errors.ts`
+   constexpr const char* wram_error_messages[] = {
+      "",
+      "invalid supply",
+      "max-supply must be positive",
+      "token with symbol already exists",
+      "symbol must be WRAM",
+      "invalid symbol name",
+      "memo has more than 256 bytes",
+      "tokens can only be issued to issuer account",
+      "must be executed by contract",
+      "invalid quantity",
+      "must issue positive quantity",
+      "symbol precision mismatch",
+      "must retire positive quantity",
+      "cannot transfer to self",
+      "must transfer positive quantity",
+      "unwrap ram is currently disabled",
+      "cannot unwrap ram to self",
+      "to account does not exist",
+      "transfer disabled to account",
+      "no balance object found",
+      "overdrawn balance",
+      "transfers cannot be empty",
+      "cannot unwrap with sendmany",
+      "quantity exceeds available supply",
+      "owner account does not exist",
+      "Balance row already deleted or never existed. Action won't have any effect.",
+      "Cannot close because the balance is not zero.",
+      "Only the system WRAM token is accepted for transfers.",
+      "cannot wrap ram to self",
+      "wrap ram is currently disabled",
+      "only eosio.wram token transfers are allowed",
+      "can only be executed once",
+      "purchase already pending",
+      "recipients cannot be empty",
+      "recipients exceed ram deposit",
+      "owners cannot be empty",
+      "settle threshold must be positive or zero",
+      "no pending bytes to settle",
+      "must quote positive quantity",
+      "quantity exceeds ram market reserve",
+      "unknown action",
+      "invalid account in memo",
+      "no ram deposit found",
+      "symbol does not exist",
+      "ram market does not exist",
+      "invalid action data",
+   };
+
+   constexpr const char* error_message( const wram_error code )
+   {
+#ifdef WRAM_ERROR_CODES
+      return "";
+#else
+      return wram_error_messages[static_cast<uint64_t>(code)];
+#endif
+   }
+
+   inline void check( const bool pred, const wram_error code )
+   {
+      if (pred) return;
+#ifdef WRAM_ERROR_CODES
+      check(false, static_cast<uint64_t>(code));
+#else
+      check(false, wram_error_messages[static_cast<uint64_t>(code)]);
+#endif
+   }
+
+   // fails with the result of a validation, `wram_error::none` passes
+   inline void check( const wram_error code )
+   {
+      check(code == wram_error::none, code);
+   }
+} /// namespace eosio
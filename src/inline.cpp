@@ -0,0 +1,56 @@
+namespace eosio {
+
+// reused by every inline action, fits `ramtransfer`, `retire` & `transfer` with a memo of up to 256 bytes
+static char inline_buffer[384];
+
+// serialized `eosio::action` header: account, action, a single `actor@active` authorization and the payload size,
+// written field by field on every call (a few fixed-size copies, nothing is cached between sends)
+static datastream<char*> begin_inline( const name account, const name action, const name actor, const size_t data_size )
+{
+   datastream<char*> ds(inline_buffer, sizeof(inline_buffer));
+   ds << account << action << unsigned_int(1) << actor << "active"_n << unsigned_int(data_size);
+   return ds;
+}
+
+static size_t memo_size( const string_view memo )
+{
+   return pack_size(unsigned_int(memo.size())) + memo.size();
+}
+
+static void end_inline( datastream<char*>& ds, const string_view memo )
+{
+   ds << unsigned_int(memo.size());
+   ds.write(memo.data(), memo.size());
+   internal_use_do_not_use::send_inline(inline_buffer, ds.tellp());
+}
+
+void wram::send_ramtransfer( const name from, const name to, const int64_t bytes, const string_view memo )
+{
+   auto ds = begin_inline("eosio"_n, "ramtransfer"_n, from, sizeof(name) * 2 + sizeof(int64_t) + memo_size(memo));
+   ds << from << to << bytes;
+   end_inline(ds, memo);
+}
+
+void wram::send_transfer( const name contract, const name to, const asset& quantity, const string_view memo )
+{
+   auto ds = begin_inline(contract, "transfer"_n, get_self(), sizeof(name) * 2 + pack_size(quantity) + memo_size(memo));
+   ds << get_self() << to << quantity;
+   end_inline(ds, memo);
+}
+
+// `transfer` of this contract between any two accounts, authorized by the contract itself
+void wram::send_receipt( const name from, const name to, const asset& quantity, const string_view memo )
+{
+   auto ds = begin_inline(get_self(), "transfer"_n, get_self(), sizeof(name) * 2 + pack_size(quantity) + memo_size(memo));
+   ds << from << to << quantity;
+   end_inline(ds, memo);
+}
+
+void wram::send_retire( const asset& quantity, const string_view memo )
+{
+   auto ds = begin_inline(get_self(), "retire"_n, get_self(), pack_size(quantity) + memo_size(memo));
+   ds << quantity;
+   end_inline(ds, memo);
+}
+
+} /// namespace eosio
@@ -0,0 +1,29 @@
+namespace eosio {
+
+// account names of up to 12 characters, checked before `name` which aborts on anything else
+static bool is_account_name( const string_view account )
+{
+   if (account.empty() || account.size() > 12) return false;
+   for (const char c : account) {
+      if (!((c >= 'a' && c <= 'z') || (c >= '1' && c <= '5') || c == '.')) return false;
+   }
+   return true;
+}
+
+wram_error wram::parse_route( const string_view memo, const string_view prefix, const name sender, name& to )
+{
+   if (memo.substr(0, prefix.size()) != prefix) return wram_error::none;
+
+   const string_view account = memo.substr(prefix.size());
+   if (account.empty()) {
+      to = sender;
+      return wram_error::none;
+   }
+   if (account[0] != ':') return wram_error::none;
+   if (!is_account_name(account.substr(1))) return wram_error::invalid_memo_account;
+
+   to = name{account.substr(1)};
+   return wram_error::none;
+}
+
+} /// namespace eosio
@@ -0,0 +1,22 @@
+namespace eosio {
+
+void wram::buy_ram( context& ctx, const name receiver, const asset quantity )
+{
+   const auto market = get_ram_market();
+   check(quantity.symbol == market.quote.balance.symbol, wram_error::symbol_precision_mismatch);
+
+   // reject before buying RAM, same checks as `wrap_ram`
+   check(receiver != get_self(), wram_error::cannot_wrap_ram_to_self);
+   check_disable_transfer(ctx, receiver);
+   check(is_account(receiver), wram_error::to_account_does_not_exist);
+
+   // consumed by `on_logbuyram` of the inline `buyram`, which completes before any other transfer is handled
+   purchase_table _purchase(get_self(), get_self().value);
+   check(!_purchase.exists(), wram_error::purchase_already_pending);
+   _purchase.set({receiver}, get_self());
+
+   eosiosystem::system_contract::buyram_action buyram_act{"eosio"_n, {get_self(), "active"_n}};
+   buyram_act.send(get_self(), get_self(), quantity);
+}
+
+} /// namespace eosio
@@ -0,0 +1,110 @@
+namespace eosio {
+
+[[eosio::action, eosio::read_only]]
+asset wram::getbalance( const name owner )
+{
+   accounts acnts(get_self(), owner.value);
+   auto itr = acnts.find(RAM_SYMBOL.code().raw());
+   return itr != acnts.end() ? itr->balance : asset{0, RAM_SYMBOL};
+}
+
+[[eosio::action, eosio::read_only]]
+vector<asset> wram::getbalances( const vector<name> owners )
+{
+   vector<asset> balances;
+   balances.reserve(owners.size());
+
+   for (const name owner : owners) {
+      balances.push_back(getbalance(owner));
+   }
+   return balances;
+}
+
+[[eosio::action, eosio::read_only]]
+asset wram::getsupply()
+{
+   return get_supply(get_self(), RAM_SYMBOL.code());
+}
+
+[[eosio::action, eosio::read_only]]
+wram::state_row wram::getstate()
+{
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   return get_state(ctx);
+}
+
+[[eosio::action, eosio::read_only]]
+vector<int64_t> wram::quote( const vector<asset> quantities )
+{
+   const auto market = get_ram_market();
+   const int64_t ram_reserve = market.base.balance.amount;
+   const int64_t eos_reserve = market.quote.balance.amount;
+
+   vector<int64_t> bytes;
+   bytes.reserve(quantities.size());
+   for (const asset& quantity : quantities) {
+      check(quantity.symbol == market.quote.balance.symbol, wram_error::symbol_precision_mismatch);
+      check(quantity.amount > 0, wram_error::must_quote_positive_quantity);
+
+      const int64_t quantity_after_fee = quantity.amount - get_fee(quantity.amount);
+      bytes.push_back(get_bancor_output(eos_reserve, ram_reserve, quantity_after_fee));
+   }
+   return bytes;
+}
+
+[[eosio::action, eosio::read_only]]
+vector<asset> wram::quotecost( const vector<int64_t> bytes )
+{
+   const auto market = get_ram_market();
+   const int64_t ram_reserve = market.base.balance.amount;
+   const int64_t eos_reserve = market.quote.balance.amount;
+
+   vector<asset> costs;
+   costs.reserve(bytes.size());
+   for (const int64_t amount : bytes) {
+      check(amount > 0, wram_error::must_quote_positive_quantity);
+      check(amount < ram_reserve, wram_error::quantity_exceeds_ram_market_reserve);
+
+      const int64_t cost = get_bancor_input(ram_reserve, eos_reserve, amount);
+      const int64_t cost_plus_fee = cost / double(0.995);
+      costs.push_back(asset{cost_plus_fee, market.quote.balance.symbol});
+   }
+   return costs;
+}
+
+eosiosystem::system_contract::exchange_state wram::get_ram_market()
+{
+   eosiosystem::system_contract::rammarket _rammarket("eosio"_n, "eosio"_n.value);
+   auto itr = _rammarket.find(eosiosystem::system_contract::ramcore_symbol.raw());
+   check(itr != _rammarket.end(), wram_error::ram_market_does_not_exist);
+   return *itr;
+}
+
+int64_t wram::get_bancor_output( const int64_t inp_reserve, const int64_t out_reserve, const int64_t inp )
+{
+   const double ib = inp_reserve;
+   const double ob = out_reserve;
+   const double in = inp;
+
+   int64_t out = int64_t((in * ob) / (ib + in));
+   if (out < 0) out = 0;
+   return out;
+}
+
+int64_t wram::get_bancor_input( const int64_t out_reserve, const int64_t inp_reserve, const int64_t out )
+{
+   const double ob = out_reserve;
+   const double ib = inp_reserve;
+
+   int64_t inp = (ib * out) / (ob - out);
+   if (inp < 0) inp = 0;
+   return inp;
+}
+
+// .5% fee (round up)
+int64_t wram::get_fee( const int64_t amount )
+{
+   return (amount + 199) / 200;
+}
+
+} /// namespace eosio
@@ -0,0 +1,51 @@
+namespace eosio {
+
+[[eosio::action]]
+void wram::sellwram( const name owner, const int64_t bytes )
+{
+   require_auth(owner);
+   check(bytes > 0, wram_error::must_transfer_positive_quantity);
+
+   // check status, selling is an unwrap to the contract itself
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   check(get_state(ctx).unwrap_ram_enabled, wram_error::unwrap_ram_disabled);
+
+   const auto market = get_ram_market();
+
+   // burn wram from the owner
+   const asset quantity{bytes, RAM_SYMBOL};
+   sub_balance(owner, quantity);
+   burn(ctx, quantity);
+   require_recipient(owner);
+
+   // move the RAM to the contract and sell it, proceeds are forwarded once `sellram` has paid out
+   send_from_bank(ctx, get_self(), bytes);
+   save_context(ctx);
+
+   eosiosystem::system_contract::sellram_action sellram_act{"eosio"_n, {get_self(), "active"_n}};
+   sellram_act.send(get_self(), bytes);
+
+   sellpayout_action sellpayout_act{get_self(), {get_self(), "active"_n}};
+   sellpayout_act.send(owner, get_eos_balance(market.quote.balance.symbol));
+}
+
+// @self
+[[eosio::action]]
+void wram::sellpayout( const name owner, const asset balance )
+{
+   require_auth(get_self());
+
+   const asset proceeds = get_eos_balance(balance.symbol) - balance;
+   if (proceeds.amount <= 0) return;
+
+   send_transfer(EOS_CONTRACT, owner, proceeds, "sell ram");
+}
+
+asset wram::get_eos_balance( const symbol sym )
+{
+   accounts acnts(EOS_CONTRACT, get_self().value);
+   auto itr = acnts.find(sym.code().raw());
+   return itr != acnts.end() ? itr->balance : asset{0, sym};
+}
+
+} /// namespace eosio
@@ -0,0 +1,58 @@
+namespace eosio {
+
+[[eosio::action]]
+void wram::settle()
+{
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   check(get_state(ctx).pending_bytes > 0, wram_error::no_pending_bytes_to_settle);
+
+   settle_pending(ctx);
+   save_context(ctx);
+}
+
+// wrapped bytes are received by the contract, either netted or sent to the rambank
+void wram::send_to_bank( context& ctx, const int64_t bytes )
+{
+   state_row& state = get_state(ctx);
+
+   // netting disabled, ramtransfer to rambank right away
+   if (state.settle_threshold == 0) {
+      send_ramtransfer(get_self(), RAM_BANK, bytes, "wrap ram");
+      return;
+   }
+
+   state.pending_bytes += bytes;
+   ctx.state_changed = true;
+   if (state.pending_bytes >= state.settle_threshold) settle_pending(ctx);
+}
+
+// unwrapped bytes are paid out of pending bytes when possible, otherwise from the rambank
+void wram::send_from_bank( context& ctx, const name to, const int64_t bytes )
+{
+   state_row& state = get_state(ctx);
+
+   // bytes kept by the contract itself (see `sellwram`) must not be wrapped again by `on_ramtransfer`
+   const char* memo = to == get_self() ? "ignore" : "unwrap ram";
+
+   if (state.pending_bytes >= bytes) {
+      state.pending_bytes -= bytes;
+      ctx.state_changed = true;
+      if (to == get_self()) return;
+
+      send_ramtransfer(get_self(), to, bytes, memo);
+      return;
+   }
+
+   send_ramtransfer(RAM_BANK, to, bytes, memo);
+}
+
+void wram::settle_pending( context& ctx )
+{
+   state_row& state = get_state(ctx);
+
+   send_ramtransfer(get_self(), RAM_BANK, state.pending_bytes, "settle ram");
+   state.pending_bytes = 0;
+   ctx.state_changed = true;
+}
+
+} /// namespace eosio
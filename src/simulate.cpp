@@ -0,0 +1,71 @@
+namespace eosio {
+
+[[eosio::action, eosio::read_only]]
+wram::simulate_result wram::simtransfer( const name from, const name to, const asset quantity, const string memo )
+{
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   transfer_plan plan{get_self(), from, to, from};
+   simulate_result result;
+
+   if (const wram_error error = validate_transfer(ctx, plan, from, to, quantity, memo); error != wram_error::none) {
+      result.error = error_message(error);
+      result.error_code = static_cast<uint64_t>(error);
+      return result;
+   }
+   result.success = true;
+   result.from_balance = plan.from_itr->balance - quantity;
+   result.supply = get_stat(ctx).supply;
+
+   // unwrap burns the tokens instead of crediting the contract
+   if (to == get_self()) {
+      result.supply -= quantity;
+      return result;
+   }
+
+   if (plan.to_itr != plan.to_acnts.end()) {
+      result.to_balance = plan.to_itr->balance + quantity;
+   } else {
+      result.to_balance = quantity;
+      result.new_balances.push_back(to);
+   }
+   return result;
+}
+
+[[eosio::action, eosio::read_only]]
+wram::simulate_result wram::simunwrap( const name owner, const int64_t bytes )
+{
+   return simtransfer(owner, get_self(), asset{bytes, RAM_SYMBOL}, "unwrap ram");
+}
+
+[[eosio::action, eosio::read_only]]
+wram::simulate_result wram::simwrap( const name from, const name to, const int64_t bytes )
+{
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   simulate_result result;
+
+   // same order as `on_ramtransfer` & `wrap_ram`, only a `wrap:<account>` receiver is checked for existence
+   wram_error error = wram_error::none;
+   if (!get_state(ctx).wrap_ram_enabled) error = wram_error::wrap_ram_disabled;
+   else if (to != from && !is_account(to)) error = wram_error::to_account_does_not_exist;
+   else error = validate_wrap(ctx, to, bytes);
+
+   if (error != wram_error::none) {
+      result.error = error_message(error);
+      result.error_code = static_cast<uint64_t>(error);
+      return result;
+   }
+   result.success = true;
+   result.supply = get_stat(ctx).supply + asset{bytes, RAM_SYMBOL};
+
+   accounts acnts(get_self(), to.value);
+   auto itr = acnts.find(RAM_SYMBOL.code().raw());
+   if (itr != acnts.end()) {
+      result.to_balance = itr->balance + asset{bytes, RAM_SYMBOL};
+   } else {
+      result.to_balance = asset{bytes, RAM_SYMBOL};
+      result.new_balances.push_back(to);
+   }
+   return result;
+}
+
+} /// namespace eosio
@@ -0,0 +1,58 @@
+namespace eosio {
+
+wram::state_row& wram::get_state( context& ctx )
+{
+   if (ctx.state_loaded) return ctx.state;
+   ctx.state_loaded = true;
+
+   ctx.state_exists = ctx._state.exists();
+   if (ctx.state_exists) {
+      ctx.state = ctx._state.get();
+      return ctx.state;
+   }
+
+   // seed from the legacy `config` & `egresslist` tables until the first write (see `initstate`)
+   config_table _config(get_self(), get_self().value);
+   config_row config = _config.get_or_default();
+   egresslist _egresslist(get_self(), get_self().value);
+
+   ctx.state.wrap_ram_enabled = config.wrap_ram_enabled;
+   ctx.state.unwrap_ram_enabled = config.unwrap_ram_enabled;
+   for (const auto& row : _egresslist) {
+      ctx.state.egress.push_back(row.account); // sorted by primary key
+   }
+   return ctx.state;
+}
+
+wram::currency_stats& wram::get_stat( context& ctx )
+{
+   if (ctx.stat_loaded) return ctx.stat;
+   ctx.stat_loaded = true;
+
+   auto itr = ctx._stats.find( RAM_SYMBOL.code().raw() );
+   check( itr != ctx._stats.end(), wram_error::symbol_does_not_exist );
+   ctx.stat = *itr;
+   return ctx.stat;
+}
+
+void wram::save_context( context& ctx )
+{
+   if (ctx.state_changed) {
+      ctx._state.set(ctx.state, get_self());
+
+      // legacy `config` is folded into `state` on its first write
+      if (!ctx.state_exists) {
+         config_table _config(get_self(), get_self().value);
+         if (_config.exists()) _config.remove();
+      }
+   }
+
+   if (ctx.stat_changed) {
+      const auto& st = ctx._stats.get( RAM_SYMBOL.code().raw() );
+      ctx._stats.modify( st, same_payer, [&]( auto& s ) {
+         s = ctx.stat;
+      });
+   }
+}
+
+} /// namespace eosio
@@ -5,12 +5,12 @@ void wram::create( const name& issuer, const asset&  maximum_supply )
     require_auth( get_self() );
 
     auto sym = maximum_supply.symbol;
-    check( maximum_supply.is_valid(), "invalid supply");
-    check( maximum_supply.amount > 0, "max-supply must be positive");
+    check( maximum_supply.is_valid(), wram_error::invalid_supply);
+    check( maximum_supply.amount > 0, wram_error::max_supply_must_be_positive);
 
     stats statstable( get_self(), sym.code().raw() );
     auto existing = statstable.find( sym.code().raw() );
-    check( existing == statstable.end(), "token with symbol already exists" );
+    check( existing == statstable.end(), wram_error::token_already_exists );
 
     statstable.emplace( get_self(), [&]( auto& s ) {
        s.supply.symbol = maximum_supply.symbol;
@@ -18,101 +18,216 @@ void wram::create( const name& issuer, const asset&  maximum_supply )
        s.issuer        = issuer;
     });
 
-    check( maximum_supply.symbol == RAM_SYMBOL, "symbol must be WRAM" );
+    check( maximum_supply.symbol == RAM_SYMBOL, wram_error::symbol_must_be_wram );
 }
 
 
 void wram::issue( const name& to, const asset& quantity, const string& memo )
 {
     auto sym = quantity.symbol;
-    check( sym.is_valid(), "invalid symbol name" );
-    check( memo.size() <= 256, "memo has more than 256 bytes" );
+    check( sym.is_valid(), wram_error::invalid_symbol_name );
+    check( memo.size() <= 256, wram_error::memo_too_long );
 
-    stats statstable( get_self(), sym.code().raw() );
-    auto existing = statstable.find( sym.code().raw() );
-    check( existing != statstable.end(), "token with symbol does not exist, create token before issue" );
-    const auto& st = *existing;
-    check( to == st.issuer, "tokens can only be issued to issuer account" );
+    context ctx{get_self(), RAM_SYMBOL.code()};
+    const auto& st = get_stat(ctx);
+    check( to == st.issuer, wram_error::issue_to_issuer_only );
 
     require_auth( st.issuer );
-    check( get_sender() == get_self(), "must be executed by contract");
-    check( quantity.is_valid(), "invalid quantity" );
-    check( quantity.amount > 0, "must issue positive quantity" );
-
-    check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
-    check( quantity.amount <= st.max_supply.amount - st.supply.amount, "quantity exceeds available supply");
+    check( get_sender() == get_self(), wram_error::must_be_executed_by_contract);
+    check( quantity.is_valid(), wram_error::invalid_quantity );
+    check( quantity.amount > 0, wram_error::must_issue_positive_quantity );
 
-    statstable.modify( st, same_payer, [&]( auto& s ) {
-       s.supply += quantity;
-    });
+    check( valid_symbol( ctx, quantity.symbol ), wram_error::symbol_precision_mismatch );
 
+    mint( ctx, quantity );
     add_balance( st.issuer, quantity, st.issuer );
+    save_context( ctx );
 }
 
 void wram::retire( const asset& quantity, const string& memo )
 {
     auto sym = quantity.symbol;
-    check( sym.is_valid(), "invalid symbol name" );
-    check( memo.size() <= 256, "memo has more than 256 bytes" );
+    check( sym.is_valid(), wram_error::invalid_symbol_name );
+    check( memo.size() <= 256, wram_error::memo_too_long );
 
-    stats statstable( get_self(), sym.code().raw() );
-    auto existing = statstable.find( sym.code().raw() );
-    check( existing != statstable.end(), "token with symbol does not exist" );
-    const auto& st = *existing;
+    context ctx{get_self(), RAM_SYMBOL.code()};
+    const auto& st = get_stat(ctx);
 
     require_auth( st.issuer );
-    check( get_sender() == get_self(), "must be executed by contract");
-    check( quantity.is_valid(), "invalid quantity" );
-    check( quantity.amount > 0, "must retire positive quantity" );
+    check( get_sender() == get_self(), wram_error::must_be_executed_by_contract);
+    check( quantity.is_valid(), wram_error::invalid_quantity );
+    check( quantity.amount > 0, wram_error::must_retire_positive_quantity );
 
-    check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
-
-    statstable.modify( st, same_payer, [&]( auto& s ) {
-       s.supply -= quantity;
-    });
+    check( valid_symbol( ctx, quantity.symbol ), wram_error::symbol_precision_mismatch );
 
+    burn( ctx, quantity );
     sub_balance( st.issuer, quantity );
+    save_context( ctx );
+}
+
+wram::transfer_result wram::transfer( const name&    from,
+                                      const name&    to,
+                                      const asset&   quantity,
+                                      const string&  memo )
+{
+    return transfer_view( from, to, quantity, memo );
 }
 
-void wram::transfer( const name&    from,
-                      const name&    to,
-                      const asset&   quantity,
-                      const string&  memo )
+wram::transfer_result wram::transfer_view( const name from, const name to, const asset quantity, const string_view memo )
 {
-    check( from != to, "cannot transfer to self" );
+    context ctx{get_self(), RAM_SYMBOL.code()};
+    const transfer_result result = transfer_tokens( ctx, from, to, quantity, memo, from );
+    save_context( ctx );
+    return result;
+}
+
+wram::transfer_result wram::transfer_tokens( context& ctx, const name& from, const name& to, const asset& quantity, const string_view memo, const name receiver )
+{
+    check( from != to, wram_error::cannot_transfer_to_self );
+
+    transfer_result result;
+
+    // receipt sent by the contract itself (see `wrap_ram` & `sendmany`), balances are already credited
+    if ( get_sender() == get_self() ) {
+        require_auth( get_self() );
+        require_recipient( to );
+        result.to_balance = get_balance( get_self(), to, quantity.symbol.code() );
+        if ( from == get_self() ) {
+            result.supply = get_stat(ctx).supply;
+            result.bytes = quantity.amount;
+        }
+        return result;
+    }
     require_auth( from );
-    check( is_account( to ), "to account does not exist");
-    auto sym = quantity.symbol.code();
-    stats statstable( get_self(), sym.raw() );
-    const auto& st = statstable.get( sym.raw() );
+
+    // cheap rejections first, no state is touched before every check has passed
+    transfer_plan plan{get_self(), from, to, receiver};
+    check( validate_transfer( ctx, plan, from, to, quantity, memo ) );
+
+    // user sends RAM token to contract
+    // burns RAM token straight from sender and transfers RAM bytes to user
+    // cannot use `on_notify` because contract cannot send inline action notifications to itself
+    result.from_balance = plan.from_itr->balance - quantity;
+    if ( to == get_self() ) {
+        unwrap_ram( ctx, plan.receiver, quantity );
+        sub_balance( plan.from_acnts, plan.from_itr, from, quantity );
+        require_recipient( from );
+
+        result.supply = get_stat(ctx).supply;
+        result.bytes = quantity.amount;
+        return result;
+    }
+
+    auto payer = has_auth( to ) ? to : from;
+    result.to_balance = plan.to_itr != plan.to_acnts.end() ? plan.to_itr->balance + quantity : quantity;
+
+    sub_balance( plan.from_acnts, plan.from_itr, from, quantity );
+    add_balance( plan.to_acnts, plan.to_itr, quantity, payer );
 
     require_recipient( from );
     require_recipient( to );
+    return result;
+}
 
-    check( quantity.is_valid(), "invalid quantity" );
-    check( quantity.amount > 0, "must transfer positive quantity" );
-    check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
-    check( memo.size() <= 256, "memo has more than 256 bytes" );
+wram_error wram::validate_transfer( context& ctx, transfer_plan& plan, const name& from, const name& to, const asset& quantity, const string_view memo )
+{
+    if ( from == to ) return wram_error::cannot_transfer_to_self;
+    if ( !quantity.is_valid() ) return wram_error::invalid_quantity;
+    if ( quantity.amount <= 0 ) return wram_error::must_transfer_positive_quantity;
+    if ( !valid_symbol( ctx, quantity.symbol ) ) return wram_error::symbol_precision_mismatch;
+    if ( memo.size() > 256 ) return wram_error::memo_too_long;
+
+    if ( to == get_self() ) {
+        if ( !get_state(ctx).unwrap_ram_enabled ) return wram_error::unwrap_ram_disabled;
+
+        // system RAM is delivered to the plan receiver unless routed with the `unwrap:<account>` memo
+        if ( const wram_error error = parse_route( memo, "unwrap", from, plan.receiver ); error != wram_error::none ) return error;
+        if ( plan.receiver != from ) {
+            if ( plan.receiver == get_self() ) return wram_error::cannot_unwrap_ram_to_self;
+            if ( !is_account( plan.receiver ) ) return wram_error::to_account_does_not_exist;
+        }
+    } else {
+        // disable transfers to accounts on egress list
+        if ( is_egress( ctx, to ) ) return wram_error::transfer_disabled_to_account;
+
+        // only a recipient without balance row has to be checked for existence
+        plan.to_itr = plan.to_acnts.find( quantity.symbol.code().raw() );
+        if ( plan.to_itr == plan.to_acnts.end() && !is_account( to ) ) return wram_error::to_account_does_not_exist;
+    }
+
+    plan.from_itr = plan.from_acnts.find( quantity.symbol.code().raw() );
+    if ( plan.from_itr == plan.from_acnts.end() ) return wram_error::no_balance_object_found;
+    if ( plan.from_itr->balance.amount < quantity.amount ) return wram_error::overdrawn_balance;
+    return wram_error::none;
+}
 
-    auto payer = has_auth( to ) ? to : from;
+void wram::sendmany( const name& from, const vector<transfer_entry>& transfers )
+{
+    require_auth( from );
+    check( !transfers.empty(), wram_error::transfers_cannot_be_empty );
+
+    context ctx{get_self(), RAM_SYMBOL.code()};
+
+    // cheap rejections first, no state is touched before every check has passed
+    asset total{0, RAM_SYMBOL};
+    for ( const transfer_entry& entry : transfers ) {
+        check( entry.to != from, wram_error::cannot_transfer_to_self );
+        check( entry.to != get_self(), wram_error::cannot_unwrap_with_sendmany );
+        check( entry.quantity.is_valid(), wram_error::invalid_quantity );
+        check( entry.quantity.amount > 0, wram_error::must_transfer_positive_quantity );
+        check( valid_symbol( ctx, entry.quantity.symbol ), wram_error::symbol_precision_mismatch );
+        check( entry.memo.size() <= 256, wram_error::memo_too_long );
+
+        // disable transfers to accounts on egress list
+        check_disable_transfer( ctx, entry.to );
+        total += entry.quantity;
+    }
+
+    // sender is debited once by the total
+    sub_balance( from, total );
+    require_recipient( from );
 
-    sub_balance( from, quantity );
-    add_balance( to, quantity, payer );
+    for ( const transfer_entry& entry : transfers ) {
+        accounts to_acnts( get_self(), entry.to.value );
+        auto to_itr = to_acnts.find( entry.quantity.symbol.code().raw() );
+        if ( to_itr == to_acnts.end() ) check( is_account( entry.to ), wram_error::to_account_does_not_exist);
 
-    // user sends RAM token to contract
-    // unwraps RAM, retires RAM token, and transfers RAM bytes to user
-    // cannot use `on_notify` because contract cannot send inline action notifications to itself
-    if ( to == get_self() ) unwrap_ram( from, quantity );
+        auto payer = has_auth( entry.to ) ? entry.to : from;
+        add_balance( to_acnts, to_itr, entry.quantity, payer );
+    }
+    save_context( ctx );
+
+    // every recipient is notified by a `transfer` receipt carrying only its own memo
+    for ( const transfer_entry& entry : transfers ) {
+        send_receipt( from, entry.to, entry.quantity, entry.memo );
+    }
+}
 
-    // disable transfers to accounts on egress list
-    check_disable_transfer( to );
+void wram::mint( context& ctx, const asset& quantity )
+{
+    auto& st = get_stat(ctx);
+    check( quantity.amount <= st.max_supply.amount - st.supply.amount, wram_error::quantity_exceeds_available_supply);
+
+    st.supply += quantity;
+    ctx.stat_changed = true;
+}
+
+void wram::burn( context& ctx, const asset& quantity )
+{
+    auto& st = get_stat(ctx);
+
+    st.supply -= quantity;
+    ctx.stat_changed = true;
 }
 
 void wram::sub_balance( const name& owner, const asset& value ) {
    accounts from_acnts( get_self(), owner.value );
+   sub_balance( from_acnts, from_acnts.find( value.symbol.code().raw() ), owner, value );
+}
 
-   const auto& from = from_acnts.get( value.symbol.code().raw(), "no balance object found" );
-   check( from.balance.amount >= value.amount, "overdrawn balance" );
+void wram::sub_balance( accounts& from_acnts, const accounts::const_iterator from, const name& owner, const asset& value ) {
+   check( from != from_acnts.end(), wram_error::no_balance_object_found );
+   check( from->balance.amount >= value.amount, wram_error::overdrawn_balance );
 
    from_acnts.modify( from, owner, [&]( auto& a ) {
       a.balance -= value;
@@ -122,7 +237,11 @@ void wram::sub_balance( const name& owner, const asset& value ) {
 void wram::add_balance( const name& owner, const asset& value, const name& ram_payer )
 {
    accounts to_acnts( get_self(), owner.value );
-   auto to = to_acnts.find( value.symbol.code().raw() );
+   add_balance( to_acnts, to_acnts.find( value.symbol.code().raw() ), value, ram_payer );
+}
+
+void wram::add_balance( accounts& to_acnts, const accounts::const_iterator to, const asset& value, const name& ram_payer )
+{
    if( to == to_acnts.end() ) {
       to_acnts.emplace( ram_payer, [&]( auto& a ){
         a.balance = value;
@@ -138,12 +257,12 @@ void wram::open( const name& owner, const symbol& symbol, const name& ram_payer
 {
    require_auth( ram_payer );
 
-   check( is_account( owner ), "owner account does not exist" );
+   check( is_account( owner ), wram_error::owner_account_does_not_exist );
+
+   context ctx{get_self(), RAM_SYMBOL.code()};
+   check( valid_symbol( ctx, symbol ), wram_error::symbol_precision_mismatch );
 
    auto sym_code_raw = symbol.code().raw();
-   stats statstable( get_self(), sym_code_raw );
-   const auto& st = statstable.get( sym_code_raw, "symbol does not exist" );
-   check( st.supply.symbol == symbol, "symbol precision mismatch" );
 
    accounts acnts( get_self(), owner.value );
    auto it = acnts.find( sym_code_raw );
@@ -159,8 +278,8 @@ void wram::close( const name& owner, const symbol& symbol )
    require_auth( owner );
    accounts acnts( get_self(), owner.value );
    auto it = acnts.find( symbol.code().raw() );
-   check( it != acnts.end(), "Balance row already deleted or never existed. Action won't have any effect." );
-   check( it->balance.amount == 0, "Cannot close because the balance is not zero." );
+   check( it != acnts.end(), wram_error::balance_row_not_found );
+   check( it->balance.amount == 0, wram_error::balance_not_zero );
    acnts.erase( it );
 }
 